@@ -4,6 +4,7 @@
 
 
 #include "src/analyze_edit_path_graphs.h"
+#include <set>
 #include <vector>
 #include <sstream>
 #include <algorithm>
@@ -19,8 +20,22 @@ int main(int argc, const char * argv[]) {
     // path generation strategy
     std::string path_generation_strategy = "Rnd_d-IsoN";
     std::string method = "F2";
+    // -perf enables the hardware performance counters per stage, -perf_json additionally writes them as JSON report
+    std::string perf_json;
+    // -sample_paths N / -sample_fraction p estimate the statistics from a uniform sample of the paths
+    size_t sample_paths = 0;
+    double sample_fraction = 1.0;
+    int seed = 42;
 
-    for (int i = 1; i < argc - 1; ++i) {
+    // arguments that are followed by a value
+    const std::set<std::string> value_arguments = {"-db", "-data", "-dataset", "-database", "-processed", "-method", "-path_strategy",
+        "-sample_paths", "-sample_fraction", "-seed", "-perf_json"};
+
+    for (int i = 1; i < argc; ++i) {
+        if (value_arguments.contains(argv[i]) && i + 1 >= argc) {
+            std::cout << "Missing value for argument: " << argv[i] << std::endl;
+            return 1;
+        }
         if (std::string(argv[i]) == "-db" || std::string(argv[i]) == "-data" || std::string(argv[i]) == "-dataset" || std::string(argv[i]) == "-database") {
             db = argv[i+1];
             ++i;
@@ -37,6 +52,30 @@ int main(int argc, const char * argv[]) {
             path_generation_strategy = argv[i+1];
             ++i;
         }
+        else if (std::string(argv[i]) == "-sample_paths") {
+            sample_paths = std::stoul(argv[i+1]);
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-sample_fraction") {
+            sample_fraction = std::stod(argv[i+1]);
+            if (sample_fraction <= 0.0 || sample_fraction > 1.0) {
+                std::cerr << "-sample_fraction must be in (0, 1]" << std::endl;
+                return 1;
+            }
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-seed") {
+            seed = std::stoi(argv[i+1]);
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-perf") {
+            PerfCounters::Instance().Enable();
+        }
+        else if (std::string(argv[i]) == "-perf_json") {
+            PerfCounters::Instance().Enable();
+            perf_json = argv[i+1];
+            ++i;
+        }
         // add help
         else if (std::string(argv[i]) == "-help") {
             // TODO
@@ -47,6 +86,11 @@ int main(int argc, const char * argv[]) {
             std::cout << "-method <GED method name>" << std::endl;
             std::cout << "-path_strategy <single strategy name>" << std::endl;
             std::cout << "-path_strategies <comma,separated,list,of,strategies>" << std::endl;
+            std::cout << "-sample_paths <number of paths to estimate the statistics from (with 95% confidence intervals)>" << std::endl;
+            std::cout << "-sample_fraction <fraction of the paths to estimate the statistics from, in (0, 1]>" << std::endl;
+            std::cout << "-seed <random seed for the path sample>" << std::endl;
+            std::cout << "-perf <measure cycles, instructions, cache and branch misses per stage>" << std::endl;
+            std::cout << "-perf_json <file> <like -perf, additionally write the measurements as JSON report>" << std::endl;
              return 0;
         }
         else {
@@ -65,5 +109,7 @@ int main(int argc, const char * argv[]) {
     }
 
 
-    return analyze_edit_path_graphs(db, edit_path_output, method);
+    const int result = analyze_edit_path_graphs(db, edit_path_output, method, sample_paths, sample_fraction, seed);
+    PerfCounters::Instance().Report("AnalyzePaths", perf_json);
+    return result;
 }
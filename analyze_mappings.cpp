@@ -2,6 +2,7 @@
 // Load mappings for a given method and dataset and compare distances
 
 
+#include <set>
 #include "src/analyze_mappings.h"
 
 int main(int argc, const char* argv[]) {
@@ -12,10 +13,20 @@ int main(int argc, const char* argv[]) {
     std::string method = "F2";
     std::string compare_method; // optional second method to compare against
     std::string csv_out; // optional CSV of pairwise comparisons
+    std::string perf_json; // optional JSON report of the performance counters (-perf / -perf_json)
+    bool lazy = false; // verify the mappings in batches, reading only the graphs of one batch (-lazy)
+
+    // arguments that are followed by a value
+    const std::set<std::string> value_arguments = {"-db", "-data", "-dataset", "-database", "-processed", "-mappings", "-method",
+        "-compare-method", "-csv-out", "-perf_json"};
 
     // parse simple argv-style (consistent with repo tools)
-    for (int i = 1; i < argc - 1; ++i) {
+    for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
+        if (value_arguments.contains(arg) && i + 1 >= argc) {
+            std::cout << "Missing value for argument: " << arg << std::endl;
+            return 1;
+        }
         if (arg == "-db" || arg == "-data" || arg == "-dataset" || arg == "-database") {
             db = argv[i+1];
             ++i;
@@ -23,8 +34,8 @@ int main(int argc, const char* argv[]) {
             processed_graph_path = argv[i+1];
             ++i;
         } else if (arg == "-mappings") {
-            ++i;
             mappings_root = argv[i+1];
+            ++i;
         } else if (arg == "-method") {
             method = argv[i+1];
             ++i;
@@ -34,12 +45,22 @@ int main(int argc, const char* argv[]) {
         } else if (arg == "-csv-out") {
             csv_out = argv[i+1];
             ++i;
+        } else if (arg == "-lazy") {
+            lazy = true;
+        } else if (arg == "-perf") {
+            PerfCounters::Instance().Enable();
+        } else if (arg == "-perf_json") {
+            PerfCounters::Instance().Enable();
+            perf_json = argv[i+1];
+            ++i;
         } else if (arg == "-help") {
             std::cout << "analyze_mappings: load GED mappings and compare distances\n";
-            std::cout << "Usage: " << argv[0] << " [-db NAME] [-method METHOD] [-compare-method OTHER_METHOD] [-mappings PATH] [-processed PATH] [-csv-out FILE]\n";
+            std::cout << "Usage: " << argv[0] << " [-db NAME] [-method METHOD] [-compare-method OTHER_METHOD] [-mappings PATH] [-processed PATH] [-csv-out FILE] [-lazy] [-perf] [-perf_json FILE]\n";
             return 0;
         }
     }
 
-    return analyze_mappings(db, processed_graph_path, mappings_root, method, compare_method, csv_out);
+    const int result = analyze_mappings(db, processed_graph_path, mappings_root, method, compare_method, csv_out, lazy);
+    PerfCounters::Instance().Report("AnalyzeMappings", perf_json);
+    return result;
 }
\ No newline at end of file
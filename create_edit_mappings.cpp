@@ -5,6 +5,7 @@
 
 #include <filesystem>
 #include <iostream>
+#include <set>
 #include <vector>
 #include "GraphDataStructures/GraphBase.h"
 #include "src/env/ged_env.hpp"
@@ -37,6 +38,7 @@ int main(const int argc, const char * argv[]) {
     int num_threads = 1;
     // -method
     auto method = "F2";
+    bool method_given = false;
     std::string method_options = "";
     auto ged_method = GEDMethodFromString(method);
     // -cost
@@ -44,8 +46,10 @@ int main(const int argc, const char * argv[]) {
     auto edit_cost = EditCostsFromString(cost);
     // -s
     auto seed = 42;
-    // -ids_path
+    // -ids_path file with the graph ids to restrict the pairs to (e.g. the training split)
     std::string graph_ids_path;
+    // -pairs_file file with explicit pairs (two graph ids per line) to compute instead of random pairs
+    std::string pairs_file;
     // -num_pairs to randomly sample from the dataset and create mappings for (-1 for all)
     int num_pairs = 5000;
 
@@ -53,26 +57,56 @@ int main(const int argc, const char * argv[]) {
     // Add single source/target arguments
     int single_source = -1;
     int single_target = -1;
+    // -numa pins the workers per NUMA node and gives every node its own replica of the graphs
+    bool numa = false;
+    // -shm_publish / -shm / -shm_unlink for multi-process runs sharing one copy of graphs and mappings
+    std::string shm_name;
+    std::string shm_publish;
+    // -lazy_cache <N> keeps at most N graphs in memory and loads the others from the preprocessed file on demand
+    size_t lazy_cache_graphs = 0;
+    // -perf enables the hardware performance counters per stage, -perf_json additionally writes them as JSON report
+    std::string perf_json;
+    // -solver_slots <N> caps the concurrent Gurobi solves of all processes on this machine using lock files in -solver_slot_dir
+    int solver_slots = 0;
+    // -batched_bipartite computes BIPARTITE upper bounds with the native batched engine instead of GEDLIB
+    bool batched_bipartite = false;
+    std::string solver_slot_dir = "/tmp/gedpaths_solver_slots";
 
-    for (int i = 1; i < argc - 1; ++i) {
+    // arguments that are followed by a value
+    const std::set<std::string> value_arguments = {"-db", "-data", "-dataset", "-database", "-raw", "-processed", "-mappings", "-t",
+        "-method", "-cost", "-seed", "-ids_path", "-pairs_file", "-num_pairs", "-single_source", "-single_target", "-shm",
+        "-shm_publish", "-shm_unlink", "-lazy_cache", "-perf_json", "-solver_slots", "-solver_slot_dir"};
+
+    for (int i = 1; i < argc; ++i) {
+        if (value_arguments.contains(argv[i]) && i + 1 >= argc) {
+            std::cout << "Missing value for argument: " << argv[i] << std::endl;
+            return 1;
+        }
         if (std::string(argv[i]) == "-db" || std::string(argv[i]) == "-data" || std::string(argv[i]) == "-dataset" || std::string(argv[i]) == "-database") {
             db = argv[i+1];
+            ++i;
         }
         else if (std::string(argv[i]) == "-raw") {
             input_path = argv[i+1];
+            ++i;
         }
         else if (std::string(argv[i]) == "-processed") {
             processed_graph_path = argv[i+1];
+            ++i;
         }
         else if (std::string(argv[i]) == "-mappings") {
             output_path = argv[i+1];
+            ++i;
         }
         else if (std::string(argv[i]) == "-t") {
             num_threads = std::stoi(argv[i+1]);
+            ++i;
         }
         else if (std::string(argv[i]) == "-method") {
             method = argv[i+1];
             ged_method = GEDMethodFromString(method);
+            method_given = true;
+            ++i;
         }
         else if (std::string(argv[i]) == "-method_options") {
             // read method options in format option value option value ... until next  leading - or end of argv
@@ -92,21 +126,68 @@ int main(const int argc, const char * argv[]) {
         else if (std::string(argv[i]) == "-cost") {
             cost = argv[i+1];
             edit_cost = EditCostsFromString(cost);
+            ++i;
         }
         else if (std::string(argv[i]) == "-seed") {
             seed = std::stoi(argv[i+1]);
+            ++i;
         }
         else if (std::string(argv[i]) == "-ids_path") {
             graph_ids_path = argv[i+1];
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-pairs_file") {
+            pairs_file = argv[i+1];
+            ++i;
         }
         else if (std::string(argv[i]) == "-num_pairs") {
             num_pairs = std::stoi(argv[i+1]);
+            ++i;
         }
         else if (std::string(argv[i]) == "-single_source") {
             single_source = std::stoi(argv[i+1]);
+            ++i;
         }
         else if (std::string(argv[i]) == "-single_target") {
             single_target = std::stoi(argv[i+1]);
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-numa") {
+            numa = true;
+        }
+        else if (std::string(argv[i]) == "-shm") {
+            shm_name = argv[i+1];
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-shm_publish") {
+            shm_publish = argv[i+1];
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-lazy_cache") {
+            lazy_cache_graphs = std::stoul(argv[i+1]);
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-perf") {
+            PerfCounters::Instance().Enable();
+        }
+        else if (std::string(argv[i]) == "-perf_json") {
+            PerfCounters::Instance().Enable();
+            perf_json = argv[i+1];
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-batched_bipartite") {
+            batched_bipartite = true;
+        }
+        else if (std::string(argv[i]) == "-solver_slots") {
+            solver_slots = std::stoi(argv[i+1]);
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-solver_slot_dir") {
+            solver_slot_dir = argv[i+1];
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-shm_unlink") {
+            return ShmGraphStore::Unlink(argv[i+1]) ? 0 : 1;
         }
         // add help
         else if (std::string(argv[i]) == "-help") {
@@ -116,6 +197,20 @@ int main(const int argc, const char * argv[]) {
             std::cout << "-raw <raw data path where db can be found>" << std::endl;
             std::cout << "-processed <processed data path>" << std::endl;
             std::cout << "-mappings <mappings path>" << std::endl;
+            std::cout << "-ids_path <file with graph ids, pairs are only sampled among these graphs>" << std::endl;
+            std::cout << "-pairs_file <file with one pair of graph ids per line to compute instead of random pairs, all listed pairs are computed (-num_pairs is ignored)>" << std::endl;
+            std::cout << "-num_pairs <number of random pairs, -1 for all, ignored with -pairs_file>" << std::endl;
+            std::cout << "-t <number of worker threads (used with -numa)>" << std::endl;
+            std::cout << "-numa <pin workers per NUMA node with node-local graph replicas>" << std::endl;
+            std::cout << "-lazy_cache <number of graphs> <out-of-core mode: load graphs on demand through an LRU cache of this size>" << std::endl;
+            std::cout << "-shm_publish <name> <load graphs and mappings once and publish them to shared memory>" << std::endl;
+            std::cout << "-shm <name> <worker mode: compute -single_source/-single_target from the shared memory segment>" << std::endl;
+            std::cout << "-shm_unlink <name> <remove the shared memory segment>" << std::endl;
+            std::cout << "-batched_bipartite <compute BIPARTITE upper bounds for many pairs with the native batched engine (CONSTANT costs), written to the BIPARTITE_BATCHED method folder, not combinable with -method and -lazy_cache>" << std::endl;
+            std::cout << "-solver_slots <N> <at most N concurrent Gurobi solves across all processes on this machine, use the same N everywhere>" << std::endl;
+            std::cout << "-solver_slot_dir <directory> <lock file directory shared by the processes (default /tmp/gedpaths_solver_slots)>" << std::endl;
+            std::cout << "-perf <measure cycles, instructions, cache and branch misses per stage>" << std::endl;
+            std::cout << "-perf_json <file> <like -perf, additionally write the measurements as JSON report>" << std::endl;
             std::cout << "-help <show this help message>" << std::endl;
             std::cout << "Usage: " << argv[0] << " -db <database name> -raw <raw data path where db can be found> -processed <processed data path> -mappings <mappings path>" << std::endl;
             return 0;
@@ -131,6 +226,20 @@ int main(const int argc, const char * argv[]) {
 
     }
 
+    if (batched_bipartite && method_given) {
+        std::cerr << "-batched_bipartite always writes to the BIPARTITE_BATCHED method folder and cannot be combined with -method" << std::endl;
+        return 1;
+    }
+    if (batched_bipartite && lazy_cache_graphs > 0) {
+        std::cerr << "-batched_bipartite works on the graphs in memory and cannot be combined with -lazy_cache" << std::endl;
+        return 1;
+    }
+    if (batched_bipartite) {
+        // own method folder, the bounds differ slightly from GEDLIB's BIPARTITE; GEDLIB BIPARTITE repairs invalid mappings
+        method = "BIPARTITE_BATCHED";
+        ged_method = GEDMethodFromString("BIPARTITE");
+    }
+
     // create mapping output directory
     if (!std::filesystem::exists(output_path)) {
         std::filesystem::create_directory(output_path);
@@ -143,6 +252,13 @@ int main(const int argc, const char * argv[]) {
     std::filesystem::create_directory(output_path + "/" + db + "/tmp/");
 
 
-    return create_edit_mappings(db, output_path, input_path, processed_graph_path,
-        edit_cost, ged_method, method_options, graph_ids_path, num_pairs, num_threads, seed, single_source, single_target);
+    if (!SolverSlots::Instance().Configure(solver_slots, solver_slot_dir)) {
+        return 1;
+    }
+    method_options = SolverSlots::Instance().LimitThreads(ged_method, method_options);
+    const int result = create_edit_mappings(db, output_path, input_path, processed_graph_path,
+        edit_cost, ged_method, method_options, graph_ids_path, pairs_file, num_pairs, num_threads, seed, single_source, single_target, numa, shm_name, shm_publish, lazy_cache_graphs, batched_bipartite);
+    SolverSlots::Instance().PrintStatistics();
+    PerfCounters::Instance().Report("CreateMappings", perf_json);
+    return result;
 }
@@ -30,6 +30,14 @@ int main(int argc, const char * argv[]) {
     std::string method = "REFINE";
     std::vector<std::string> path_strategies = {"Random"};
     bool connected_only = false;
+    // -perf enables the hardware performance counters per stage, -perf_json additionally writes them as JSON report
+    std::string perf_json;
+    // -min_distance, -max_distance, -max_gap, -graph_ids and -sample select mappings through the mapping index
+    MappingSelection selection;
+    // -lazy reads only the graphs of the selected mappings from the preprocessed file instead of the whole dataset
+    bool lazy = false;
+    // -distinct_only skips the mappings between graphs with equal WL hash (from the graph features of CreateMappings)
+    bool distinct_only = false;
 
     int source_id = -1;
     int target_id = -1;
@@ -84,6 +92,42 @@ int main(int argc, const char * argv[]) {
         else if (std::string(argv[i]) == "-connected_only") {
             connected_only = true;
         }
+        else if (std::string(argv[i]) == "-min_distance") {
+            selection.min_distance = std::stod(argv[i+1]);
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-max_distance") {
+            selection.max_distance = std::stod(argv[i+1]);
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-max_gap") {
+            selection.max_gap = std::stod(argv[i+1]);
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-graph_ids") {
+            if (!read_graph_ids(argv[i+1], selection.graph_ids)) {
+                return 1;
+            }
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-sample") {
+            selection.sample = std::stoul(argv[i+1]);
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-lazy") {
+            lazy = true;
+        }
+        else if (std::string(argv[i]) == "-distinct_only") {
+            distinct_only = true;
+        }
+        else if (std::string(argv[i]) == "-perf") {
+            PerfCounters::Instance().Enable();
+        }
+        else if (std::string(argv[i]) == "-perf_json") {
+            PerfCounters::Instance().Enable();
+            perf_json = argv[i+1];
+            ++i;
+        }
         // add help
         else if (std::string(argv[i]) == "-help") {
             std::cout << "Create edit paths from GED mappings" << std::endl;
@@ -95,6 +139,15 @@ int main(int argc, const char * argv[]) {
             std::cout << "-method <GED method name>" << std::endl;
             std::cout << "-source_id <source graph id>" << std::endl;
             std::cout << "-target_id <target graph id>" << std::endl;
+            std::cout << "-min_distance <only mappings with at least this distance>" << std::endl;
+            std::cout << "-max_distance <only mappings with at most this distance>" << std::endl;
+            std::cout << "-max_gap <only mappings with at most this gap between upper and lower bound>" << std::endl;
+            std::cout << "-graph_ids <file with graph ids, only mappings between these graphs>" << std::endl;
+            std::cout << "-sample <number of mappings drawn uniformly from the selected ones>" << std::endl;
+            std::cout << "-distinct_only <skip mappings between graphs with equal WL hash, needs the graph features of CreateMappings>" << std::endl;
+            std::cout << "-lazy <read only the graphs of the selected mappings, needs the mapping index>" << std::endl;
+            std::cout << "-perf <measure cycles, instructions, cache and branch misses per stage>" << std::endl;
+            std::cout << "-perf_json <file> <like -perf, additionally write the measurements as JSON report>" << std::endl;
             std::cout << "-help <show this help message>" << std::endl;
              return 0;
         }
@@ -104,7 +157,7 @@ int main(int argc, const char * argv[]) {
         }
     }
 
-    return create_edit_paths(db,
+    const int result = create_edit_paths(db,
                              processed_graph_path,
                              mappings_path,
                              edit_path_output,
@@ -114,5 +167,10 @@ int main(int argc, const char * argv[]) {
                              connected_only,
                              path_strategies,
                              source_id,
-                             target_id);
+                             target_id,
+                             selection,
+                             lazy,
+                             distinct_only);
+    PerfCounters::Instance().Report("CreatePaths", perf_json);
+    return result;
 }
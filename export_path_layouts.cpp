@@ -0,0 +1,153 @@
+// Export path-consistent node layouts of edit paths for the plotting scripts
+
+#include "src/export_path_layouts.h"
+#include <charconv>
+#include <cstring>
+#include <set>
+#include <string>
+
+// Parse the whole argument text as a number, false if it is none or out of range for T
+template <typename T>
+bool parse_number_argument(const char* text, T& value) {
+    const char* end = text + std::strlen(text);
+    const auto [ptr, error] = std::from_chars(text, end, value);
+    return error == std::errc() && ptr == end;
+}
+
+int main(int argc, const char * argv[]) {
+    // -db argument for the database
+    std::string db = "MUTAG";
+    // -edit_paths base argument for the path where the edit paths are stored
+    std::string edit_path_output = "../Results/Paths/";
+    // -mappings base path of the mappings (their index gives the node map of every path), -processed of the dataset
+    std::string mappings_path = "../Results/Mappings/";
+    std::string processed_graph_path = "../Data/ProcessedGraphs/";
+    // path generation strategy
+    std::string path_generation_strategy = "Rnd_d-IsoN";
+    std::string method = "F2";
+    // -pairs_file restricts the export to these (source, target) pairs, -num_paths to the first N paths
+    std::string pairs_file;
+    size_t num_paths = 0;
+    // -iterations of the layout of the union graph, -refine_iterations per step
+    int iterations = 300;
+    int refine_iterations = 20;
+    int seed = 42;
+    int num_threads = 1;
+    // -out layout file, default <edit path folder>/<db>_path_layouts.bin
+    std::string output_file;
+    // -perf enables the hardware performance counters per stage, -perf_json additionally writes them as JSON report
+    std::string perf_json;
+
+    // arguments that are followed by a value
+    const std::set<std::string> value_arguments = {"-db", "-data", "-dataset", "-database", "-edit_paths", "-mappings", "-processed",
+        "-method", "-path_strategy", "-pairs_file", "-num_paths", "-iterations", "-refine_iterations", "-seed", "-t", "-out", "-perf_json"};
+
+    for (int i = 1; i < argc; ++i) {
+        if (value_arguments.contains(argv[i]) && i + 1 >= argc) {
+            std::cout << "Missing value for argument: " << argv[i] << std::endl;
+            return 1;
+        }
+        // false if a numeric argument has an invalid value
+        bool valid_value = true;
+        if (std::string(argv[i]) == "-db" || std::string(argv[i]) == "-data" || std::string(argv[i]) == "-dataset" || std::string(argv[i]) == "-database") {
+            db = argv[i+1];
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-edit_paths") {
+            edit_path_output = argv[i+1];
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-mappings") {
+            mappings_path = argv[i+1];
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-processed") {
+            processed_graph_path = argv[i+1];
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-method") {
+            method = argv[i+1];
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-path_strategy") {
+            path_generation_strategy = argv[i+1];
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-pairs_file") {
+            pairs_file = argv[i+1];
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-num_paths") {
+            valid_value = parse_number_argument(argv[i+1], num_paths);
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-iterations") {
+            valid_value = parse_number_argument(argv[i+1], iterations) && iterations >= 0;
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-refine_iterations") {
+            valid_value = parse_number_argument(argv[i+1], refine_iterations) && refine_iterations >= 0;
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-seed") {
+            valid_value = parse_number_argument(argv[i+1], seed);
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-t") {
+            valid_value = parse_number_argument(argv[i+1], num_threads) && num_threads >= 1;
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-out") {
+            output_file = argv[i+1];
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-perf") {
+            PerfCounters::Instance().Enable();
+        }
+        else if (std::string(argv[i]) == "-perf_json") {
+            PerfCounters::Instance().Enable();
+            perf_json = argv[i+1];
+            ++i;
+        }
+        else if (std::string(argv[i]) == "-help") {
+            std::cout << "Export path-consistent node layouts of edit paths" << std::endl;
+            std::cout << "Arguments:" << std::endl;
+            std::cout << "-db | -data | -dataset | -database <database name>" << std::endl;
+            std::cout << "-edit_paths <edit paths path>" << std::endl;
+            std::cout << "-mappings <mappings path, the mapping index gives the node map of every path>" << std::endl;
+            std::cout << "-processed <processed data path with the source and target graphs>" << std::endl;
+            std::cout << "-method <GED method name>" << std::endl;
+            std::cout << "-path_strategy <single strategy name>" << std::endl;
+            std::cout << "-pairs_file <file with one pair of graph ids per line, only these paths are exported>" << std::endl;
+            std::cout << "-num_paths <export at most this many paths, 0 for all>" << std::endl;
+            std::cout << "-iterations <Fruchterman-Reingold iterations of the union graph of a path>" << std::endl;
+            std::cout << "-refine_iterations <refinement iterations per step>" << std::endl;
+            std::cout << "-seed <random seed of the initial positions>" << std::endl;
+            std::cout << "-t <number of threads>" << std::endl;
+            std::cout << "-out <layout file, default <edit path folder>/<db>_path_layouts.bin>" << std::endl;
+            std::cout << "-perf <measure cycles, instructions, cache and branch misses per stage>" << std::endl;
+            std::cout << "-perf_json <file> <like -perf, additionally write the measurements as JSON report>" << std::endl;
+            return 0;
+        }
+        else {
+            std::cout << "Unknown argument: " << argv[i] << std::endl;
+            return 1;
+        }
+        if (!valid_value) {
+            std::cout << "Invalid value for argument " << argv[i - 1] << ": " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    // in edit_path_output search for Paths/ and replace this by Paths_<path_generation_strategy>/
+    size_t pos = edit_path_output.find("Paths/");
+    if (pos != std::string::npos) {
+        edit_path_output.replace(pos, 6, "Paths_" + path_generation_strategy + "/");
+    } else {
+        edit_path_output += "Paths_" + path_generation_strategy + "/";
+    }
+
+    const int result = export_path_layouts(db, edit_path_output, mappings_path, processed_graph_path, method, pairs_file, num_paths, iterations, refine_iterations, seed, num_threads, output_file);
+    PerfCounters::Instance().Report("ExportPathLayouts", perf_json);
+    return result;
+}
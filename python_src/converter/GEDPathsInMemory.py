@@ -23,7 +23,7 @@ from __future__ import annotations
 from collections import defaultdict
 from typing import Dict, List, Tuple, cast, Any, Optional
 
-from python_src.converter.torch_geometric_exporter import BGFInMemoryDataset
+from python_src.converter.torch_geometric_exporter import BGFInMemoryDataset, bgf_read_selected_graphs
 from torch_geometric.data import Data
 from dataclasses import dataclass
 import os
@@ -45,6 +45,83 @@ class EditOperation:
     operation: Dict[str, Any]
 
 
+def load_edit_path_operations(path: str) -> Dict[Tuple[int, int], List[EditOperation]]:
+    """Parse an edit-path data file into EditOperation objects.
+
+    The repository contains C++ code that writes edit path info as a binary
+    file (`ReadEditPathInfo` / `WriteEditPathInfo`). There isn't a Python
+    reader in the repo; to be robust we support two simple text formats:
+    1) A CSV-like text where each line encodes: source,step,target,op_type,op_object,...
+    2) A whitespace-separated integer sequence per operation: source step target type object [extra...]
+
+    This parser will attempt to autodetect a simple CSV or whitespace format.
+    Returns the operations keyed by (source,target), ordered by step.
+    """
+    if not os.path.exists(path):
+        raise FileNotFoundError(path)
+
+    ops_by_pair: Dict[Tuple[int, int], List[Tuple[int, EditOperation]]] = defaultdict(list)
+    with open(path, "r", encoding="utf-8") as fh:
+        for raw in fh:
+            line = raw.strip()
+            if not line or line.startswith("#"):
+                continue
+            # try CSV (commas) first
+            if "," in line:
+                parts = [p.strip() for p in line.split(",")]
+            else:
+                parts = line.split()
+
+            # Need at least source, step, target
+            if len(parts) < 3:
+                continue
+            try:
+                source = int(parts[0])
+                step = int(parts[1])
+                target = int(parts[2])
+            except ValueError:
+                # not parseable; skip
+                continue
+
+            # remaining fields describe operation; keep as raw tokens and also try to infer
+            op_tokens = parts[3:]
+            op_dict: Dict[str, Any] = {"raw": op_tokens}
+            if op_tokens:
+                # try common encoding: type (INSERT/DELETE/RELABEL) and object (NODE/EDGE)
+                t = op_tokens[0].upper()
+                if t in ("INSERT", "DELETE", "RELABEL"):
+                    op_dict["type"] = t
+                    if len(op_tokens) > 1:
+                        obj = op_tokens[1].upper()
+                        op_dict["object"] = obj
+            edop = EditOperation(source=source, step=step, target=target, operation=op_dict)
+            ops_by_pair[(source, target)].append((step, edop))
+
+    # sort lists by step
+    return {pair: [op for _s, op in sorted(step_ops, key=lambda si: si[0])] for pair, step_ops in ops_by_pair.items()}
+
+
+def load_path_graphs(bgf_path: str, pairs) -> Dict[Tuple[int, int], List[Data]]:
+    """Read only the step graphs of the (start, end) paths in `pairs` from an edit-path BGF file.
+
+    Unlike `GEDPathsInMemoryDataset` this needs no processed .pt file and never reads the graphs of
+    other paths. Returns (start, end) -> Data objects ordered by edit step.
+    """
+    wanted = {(int(a), int(b)) for a, b in pairs}
+
+    def _select(_index: int, name: str) -> bool:
+        parts = name.split("_")
+        try:
+            return len(parts) > 3 and (int(parts[-3]), int(parts[-2])) in wanted
+        except ValueError:
+            return False
+
+    paths: Dict[Tuple[int, int], List[Data]] = defaultdict(list)
+    for d in bgf_read_selected_graphs(bgf_path, _select):
+        paths[(d.edit_path_start, d.edit_path_end)].append(d)
+    return {pair: sorted(graphs, key=lambda d: d.edit_path_step) for pair, graphs in paths.items()}
+
+
 class GEDPathsInMemoryDataset(BGFInMemoryDataset):
     """In-memory dataset helper for GED edit-path graphs.
 
@@ -184,62 +261,8 @@ class GEDPathsInMemoryDataset(BGFInMemoryDataset):
         return list(self._pair_to_operations.get((int(start), int(end)), []))
 
     def _load_edit_path_data(self, path: str) -> None:
-        """Parse an edit-path data file into EditOperation objects.
-
-        The repository contains C++ code that writes edit path info as a binary
-        file (`ReadEditPathInfo` / `WriteEditPathInfo`). There isn't a Python
-        reader in the repo; to be robust we support two simple text formats:
-        1) A CSV-like text where each line encodes: source,step,target,op_type,op_object,...
-        2) A whitespace-separated integer sequence per operation: source step target type object [extra...]
-
-        This parser will attempt to autodetect a simple CSV or whitespace format.
-        It will populate `_pair_to_operations` keyed by (source,target) with
-        operations ordered by step.
-        """
-        if not os.path.exists(path):
-            raise FileNotFoundError(path)
-
-        ops_by_pair: Dict[Tuple[int, int], List[Tuple[int, EditOperation]]] = defaultdict(list)
-        with open(path, "r", encoding="utf-8") as fh:
-            for raw in fh:
-                line = raw.strip()
-                if not line or line.startswith("#"):
-                    continue
-                # try CSV (commas) first
-                if "," in line:
-                    parts = [p.strip() for p in line.split(",")]
-                else:
-                    parts = line.split()
-
-                # Need at least source, step, target
-                if len(parts) < 3:
-                    continue
-                try:
-                    source = int(parts[0])
-                    step = int(parts[1])
-                    target = int(parts[2])
-                except ValueError:
-                    # not parseable; skip
-                    continue
-
-                # remaining fields describe operation; keep as raw tokens and also try to infer
-                op_tokens = parts[3:]
-                op_dict: Dict[str, Any] = {"raw": op_tokens}
-                if op_tokens:
-                    # try common encoding: type (INSERT/DELETE/RELABEL) and object (NODE/EDGE)
-                    t = op_tokens[0].upper()
-                    if t in ("INSERT", "DELETE", "RELABEL"):
-                        op_dict["type"] = t
-                        if len(op_tokens) > 1:
-                            obj = op_tokens[1].upper()
-                            op_dict["object"] = obj
-                edop = EditOperation(source=source, step=step, target=target, operation=op_dict)
-                ops_by_pair[(source, target)].append((step, edop))
-
-        # sort lists by step and store
-        for pair, step_ops in ops_by_pair.items():
-            sorted_ops = [op for _s, op in sorted(step_ops, key=lambda si: si[0])]
-            self._pair_to_operations[pair] = sorted_ops
+        """Parse an edit-path data file (see `load_edit_path_operations`) into `_pair_to_operations`."""
+        self._pair_to_operations.update(load_edit_path_operations(path))
 
 
 # Optional simple CLI when the module is executed directly
@@ -298,6 +298,81 @@ def bgf_to_pyg_data_list(
     return data_list, num_node_labels, num_node_attributes, num_edge_labels, num_edge_attributes
 
 
+def bgf_read_selected_graphs(
+        path: str,
+        select,
+        *,
+        endian: str = "<",
+        size_t_bytes: int = 8,
+        undirected: bool = True,
+) -> List[Data]:
+    """
+    Read only the graphs of a BGF file for which `select(index, name)` is true.
+    All headers come before the graph data, so the data offset of every graph follows from the
+    headers; the file is seeked to the selected graphs and the others are never read.
+    Node and edge features keep their raw values (no one-hot encoding of the label columns),
+    primary labels and the edit path attributes are set as in `bgf_to_pyg_data_list`.
+    """
+    assert endian in ("<", ">")
+    assert size_t_bytes in (4, 8)
+    st_dtype = np.dtype("u8" if size_t_bytes == 8 else "u4").newbyteorder(endian)
+    dbl_dtype = np.dtype("f8").newbyteorder(endian)
+
+    data_list: List[Data] = []
+    with open(path, "rb") as f:
+        _read_int(f, endian)  # compatibility format version
+        graph_number = _read_int(f, endian)
+        if graph_number < 0 or graph_number > 10**7:
+            raise ValueError("Unreasonable graph count; check endianness/size_t.")
+        headers: List[_GraphHeader] = []
+        for _ in range(graph_number):
+            name = _read_string(f, endian)
+            gtype = _read_int(f, endian)
+            n = _read_size_t(f, endian, size_t_bytes)
+            nf = _read_uint(f, endian)
+            node_feature_names = [_read_string(f, endian) for _ in range(nf)]
+            m = _read_size_t(f, endian, size_t_bytes)
+            ef = _read_uint(f, endian)
+            edge_feature_names = [_read_string(f, endian) for _ in range(ef)]
+            headers.append(_GraphHeader(name, int(gtype), int(n), int(nf), node_feature_names, int(m), int(ef), edge_feature_names))
+
+        offset = f.tell()
+        for idx, h in enumerate(headers):
+            edge_fields = [("u", st_dtype), ("v", st_dtype)] + ([("f", dbl_dtype, (h.edge_features,))] if h.edge_features > 0 else [])
+            edge_dtype = np.dtype(edge_fields)
+            graph_bytes = h.node_number * h.node_features * dbl_dtype.itemsize + h.edge_number * edge_dtype.itemsize
+            if not select(idx, h.name):
+                offset += graph_bytes
+                continue
+            f.seek(offset)
+            offset += graph_bytes
+            x_np = _read_np_block(f, dbl_dtype, h.node_number * h.node_features).reshape((h.node_number, h.node_features))
+            edges = _read_np_block(f, edge_dtype, h.edge_number)
+            ei = np.vstack([edges["u"], edges["v"]]).astype(np.int64) if h.edge_number > 0 else np.empty((2, 0), dtype=np.int64)
+            if ei.size and ei.max() >= h.node_number:
+                raise ValueError("Invalid edge index; check endianness/size_t.")
+            ea = np.array(edges["f"], dtype=np.float32).reshape((h.edge_number, h.edge_features)) if h.edge_features > 0 else None
+            if undirected and ei.shape[1] > 0:
+                ei = np.concatenate([ei, ei[[1, 0], :]], axis=1)
+                ea = np.vstack([ea, ea]) if ea is not None else None
+
+            x = torch.from_numpy(x_np.astype(np.float32)) if x_np.size else None
+            edge_attr = torch.from_numpy(ea) if ea is not None and ea.size else None
+            d = Data(x=x, edge_index=torch.from_numpy(ei), edge_attributes=edge_attr)
+            d.bgf_name = h.name
+            nli = next((j for j, nm in enumerate(h.node_feature_names) if nm.lower() == 'label'), -1)
+            eli = next((j for j, nm in enumerate(h.edge_feature_names) if nm.lower() == 'label'), -1)
+            d.primary_node_labels = torch.from_numpy(x_np[:, nli].copy()).type(torch.long) if nli >= 0 and x_np.size else None
+            d.primary_edge_labels = torch.from_numpy(ea[:, eli].copy()).type(torch.long) if eli >= 0 and ea is not None else None
+            bgf_name_parts = h.name.split("_")
+            if len(bgf_name_parts) > 3:
+                d.edit_path_start = int(bgf_name_parts[-3])
+                d.edit_path_end = int(bgf_name_parts[-2])
+                d.edit_path_step = int(bgf_name_parts[-1])
+            data_list.append(d)
+    return data_list
+
+
 # -------- optional: InMemoryDataset wrapper --------
 
 class BGFInMemoryDataset(InMemoryDataset):
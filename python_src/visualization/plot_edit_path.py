@@ -1,14 +1,41 @@
 import os
 try:
     # when executed as module/package
-    from .visualization_functions import plot_edit_path, find_processed_pt
+    from .visualization_functions import plot_edit_path, find_processed_pt, load_path_layouts
 except Exception:
     # when executed directly
-    from visualization_functions import plot_edit_path, find_processed_pt
-from python_src.converter.GEDPathsInMemory import GEDPathsInMemoryDataset
+    from visualization_functions import plot_edit_path, find_processed_pt, load_path_layouts
+from python_src.converter.GEDPathsInMemory import GEDPathsInMemoryDataset, load_edit_path_operations, load_path_graphs
 import argparse
 
 
+def plot_path(path_graphs, edit_operations, start, end, output_path, args, layouts=None):
+    """Plot one edit path as combined figure and (when saving) one figure per step."""
+    out_file = os.path.join(output_path, f"edit_path_{start}_{end}.png")
+    # Save combined subplot figure for the whole edit path
+    if args.save:
+        plot_edit_path(path_graphs, edit_operations, output=out_file, node_size=args.node_size, edge_width=args.edge_width, red_font_size=args.red_font_size, layouts=layouts)
+        print(f"Edit path plot saved to {out_file}")
+    else:
+        plot_edit_path(path_graphs, edit_operations, output=None, node_size=args.node_size, edge_width=args.edge_width, red_font_size=args.red_font_size, layouts=layouts)
+
+    # Additionally save individual plots — one file per graph in the path
+    # named edit_path_{start}_{end}_step_{i}.png
+    if args.save:
+        for i, g in enumerate(path_graphs):
+            # corresponding op if available
+            op = edit_operations[i] if i < len(edit_operations) else None
+            # Provide a filename prefix WITHOUT the '_step' suffix; the plotting
+            single_out_prefix = os.path.join(output_path, f"edit_path_{start}_{end}_step_{i}")
+            # plot single-step graph and save to file (plot_edit_path will add the step index)
+            try:
+                plot_edit_path([g], [op], output=single_out_prefix, node_size=args.node_size, edge_width=args.edge_width, red_font_size=args.red_font_size, one_fig_per_step=True,
+                               layouts=[layouts[i]] if layouts else None)
+                print(f"Saved single-step plot for step {i} (prefix: {single_out_prefix})")
+            except Exception as e:
+                print(f"Failed to save single-step plot for step {i}: {e}")
+
+
 def main():
     parser = argparse.ArgumentParser(description='Plot a single edit path using the same args as plot_edit_path_stats')
     default_dir = 'Results/Paths/F2/MUTAG'
@@ -24,14 +51,18 @@ def main():
     parser.add_argument('--no-save', dest='save', action='store_false', help='Do not save generated plot')
     parser.set_defaults(save=True)
     parser.add_argument('--show', action='store_true', help='Display plot interactively')
-    parser.add_argument('--start', type=int, default=0, help='Start index for paths (default: 3)')
-    parser.add_argument('--end', type=int, default=55, help='End index for paths (default: 77)')
+    parser.add_argument('--start', type=int, default=None, help='Start index for paths (default: 0, with --layout all paths of the layout file)')
+    parser.add_argument('--end', type=int, default=None, help='End index for paths (default: 55, with --layout all paths of the layout file)')
     parser.add_argument('--node-size', dest='node_size', type=int, default=200,
                         help='Default node marker size for plots (default: %(default)s)')
     parser.add_argument('--edge-width', dest='edge_width', type=float, default=1.0,
                         help='Default edge width for highlighted edges/text (default: %(default)s)')
     parser.add_argument('--red-font-size', dest='red_font_size', type=int, default=20,
                         help='Font size for red node id labels (default: %(default)s)')
+    parser.add_argument('--layout', dest='layout', default=None, nargs='?', const='',
+                        help='Use the node positions of an ExportPathLayouts file instead of computing a layout per step '
+                             '(without a value: {directory}/{database}_path_layouts.bin). Plots all paths of the file '
+                             '(or only --start/--end) and reads only their graphs from the edit path .bgf, no processed .pt needed')
     args = parser.parse_args()
 
     # Determine directory: if positional default was used, build from strategy/method/database
@@ -50,41 +81,41 @@ def main():
 
     os.makedirs(output_path, exist_ok=True)
 
+    if args.layout is not None:
+        # stable positions of all steps from the exported layout file, only the graphs of its paths are read
+        layout_file = args.layout or os.path.join(root_dir, f"{args.database}_path_layouts.bin")
+        pairs = None
+        if args.start is not None or args.end is not None:
+            pairs = [(0 if args.start is None else args.start, 55 if args.end is None else args.end)]
+        path_layouts = load_path_layouts(layout_file, pairs=pairs)
+        if not path_layouts:
+            print(f"No matching paths in {layout_file}")
+            return
+        bgf_file = os.path.join(root_dir, f"{args.database}_edit_paths.bgf")
+        graphs_by_path = load_path_graphs(bgf_file, path_layouts.keys())
+        operations_by_path = load_edit_path_operations(edit_path_file) if os.path.exists(edit_path_file) else {}
+        for (start, end), steps in sorted(path_layouts.items()):
+            path_graphs = graphs_by_path.get((start, end), [])
+            if len(path_graphs) != len(steps):
+                print(f"Path {start} -> {end} has {len(steps)} steps in {layout_file} but {len(path_graphs)} graphs in {bgf_file}, skipped")
+                continue
+            edit_operations = [op.operation["raw"] for op in operations_by_path.get((start, end), [])]
+            plot_path(path_graphs, edit_operations, start, end, output_path, args, layouts=[step['pos'] for step in steps])
+        return
+
     # Load processed dataset
     processed_pt = find_processed_pt(processed_dir)
     assert processed_pt is not None, f"Processed .pt file not found in {processed_dir}"
     ds = GEDPathsInMemoryDataset(root_dir, path=processed_pt, edit_path_data=edit_path_file)
 
-    start = args.start
-    end = args.end
+    start = 0 if args.start is None else args.start
+    end = 55 if args.end is None else args.end
     path_graphs = ds.get_path_graphs(start, end)
     tmp_edit_operations = ds.get_path_operations(start, end)
     edit_operations = []
     for op in tmp_edit_operations:
         edit_operations.append(op.operation["raw"])  # extract raw dict
-
-    out_file = os.path.join(output_path, f"edit_path_{start}_{end}.png")
-    # Save combined subplot figure for the whole edit path
-    if args.save:
-        plot_edit_path(path_graphs, edit_operations, output=out_file, node_size=args.node_size, edge_width=args.edge_width, red_font_size=args.red_font_size)
-        print(f"Edit path plot saved to {out_file}")
-    else:
-        plot_edit_path(path_graphs, edit_operations, output=None, node_size=args.node_size, edge_width=args.edge_width, red_font_size=args.red_font_size)
-
-    # Additionally save individual plots — one file per graph in the path
-    # named edit_path_{start}_{end}_step_{i}.png
-    if args.save:
-        for i, g in enumerate(path_graphs):
-            # corresponding op if available
-            op = edit_operations[i] if i < len(edit_operations) else None
-            # Provide a filename prefix WITHOUT the '_step' suffix; the plotting
-            single_out_prefix = os.path.join(output_path, f"edit_path_{start}_{end}_step_{i}")
-            # plot single-step graph and save to file (plot_edit_path will add the step index)
-            try:
-                plot_edit_path([g], [op], output=single_out_prefix, node_size=args.node_size, edge_width=args.edge_width, red_font_size=args.red_font_size, one_fig_per_step=True)
-                print(f"Saved single-step plot for step {i} (prefix: {single_out_prefix})")
-            except Exception as e:
-                print(f"Failed to save single-step plot for step {i}: {e}")
+    plot_path(path_graphs, edit_operations, start, end, output_path, args)
 
 
 if __name__ == '__main__':
@@ -168,6 +168,48 @@ def find_processed_pt(path: str) -> Optional[str]:
     return None
 
 
+def load_path_layouts(path: str, pairs=None):
+    """Read a layout file written by ExportPathLayouts.
+
+    Returns a dict (source_id, target_id) -> list of steps. Each step is a dict with
+    'pos' (node index of the step graph -> (x, y)), 'ids' (union node id per node) and
+    'deltas' (list of (type, a, b) with union node ids, b = -1 for node operations).
+    If `pairs` is given, only these (source, target) pairs are decoded.
+    """
+    import struct
+    delta_types = ['INSERT_NODE', 'DELETE_NODE', 'RELABEL_NODE', 'INSERT_EDGE', 'DELETE_EDGE', 'RELABEL_EDGE']
+    wanted = None if pairs is None else {(int(a), int(b)) for a, b in pairs}
+    with open(path, 'rb') as fh:
+        data = fh.read()
+    magic, version, num_paths = struct.unpack_from('<QIQ', data, 0)
+    if magic != 0x54554f59414c5047 or version != 1:
+        raise ValueError(f"{path} is not a path layout file (version 1)")
+    offset = struct.calcsize('<QIQ')
+    layouts = {}
+    for _ in range(num_paths):
+        source, target, _union_nodes, num_steps = struct.unpack_from('<QQII', data, offset)
+        offset += struct.calcsize('<QQII')
+        decode = wanted is None or (source, target) in wanted
+        steps = []
+        for _step in range(num_steps):
+            nodes, num_deltas = struct.unpack_from('<II', data, offset)
+            offset += 8
+            if decode:
+                ids = np.frombuffer(data, dtype='<u4', count=nodes, offset=offset)
+                xy = np.frombuffer(data, dtype='<f4', count=2 * nodes, offset=offset + 4 * nodes).reshape(-1, 2)
+                deltas = []
+                for d in range(num_deltas):
+                    t, a, b = struct.unpack_from('<B3xII', data, offset + 12 * nodes + 12 * d)
+                    deltas.append((delta_types[t], int(a), -1 if b == 0xFFFFFFFF else int(b)))
+                steps.append({'ids': ids.tolist(),
+                              'pos': {i: (float(xy[i, 0]), float(xy[i, 1])) for i in range(nodes)},
+                              'deltas': deltas})
+            offset += 12 * nodes + 12 * num_deltas
+        if decode:
+            layouts[(int(source), int(target))] = steps
+    return layouts
+
+
 def load_data_by_index(processed_pt: str, idx: int):
     ds = _LoadedInMemoryDataset(processed_pt)
     if idx < 0 or idx >= len(ds):
@@ -511,7 +553,7 @@ def plot_graph(data, title: Optional[str] = None, show_node_labels: bool = True,
         plt.show()
 
 
-def plot_edit_path(graphs, edit_ops, output=None, show_labels=True, one_fig_per_step = False, color_nodes_by_label: bool = True, node_size: int = 200, edge_width: float = 1.0, red_font_size: int = 10):
+def plot_edit_path(graphs, edit_ops, output=None, show_labels=True, one_fig_per_step = False, color_nodes_by_label: bool = True, node_size: int = 200, edge_width: float = 1.0, red_font_size: int = 10, layouts=None):
     """
     Visualize an edit path between two graphs.
     Args:
@@ -521,6 +563,7 @@ def plot_edit_path(graphs, edit_ops, output=None, show_labels=True, one_fig_per_
         highlight_colors: dict mapping operation types to colors (optional).
         show_labels: whether to show node labels.
         one_fig_per_step: plot one figure per step or all steps as subplots in one figure
+        layouts: optional list with one position dict per step (see load_path_layouts), replaces the layout computation
     """
     import matplotlib.pyplot as plt
     import networkx as nx
@@ -956,7 +999,7 @@ def plot_edit_path(graphs, edit_ops, output=None, show_labels=True, one_fig_per_
         # Save the source (initial) graph as the first plot (no title and with '_title')
         try:
             data_src = graphs[0]
-            pos_src = compute_layout(data_src)
+            pos_src = layouts[0] if layouts else compute_layout(data_src)
             # Build source output paths
             if output:
                 if os.path.isdir(output) or output.endswith(os.path.sep):
@@ -1015,8 +1058,10 @@ def plot_edit_path(graphs, edit_ops, output=None, show_labels=True, one_fig_per_
             if step > 0:
                 title = f"Step {step}" + f": {edit_ops[step-1]}"
 
-            # compute/derive positions: reuse prev_pos where possible
-            if step == 0:
+            # compute/derive positions: precomputed layout, else reuse prev_pos where possible
+            if layouts is not None and step < len(layouts):
+                pos_for_step = layouts[step]
+            elif step == 0:
                 pos_for_step = compute_layout(data)
             else:
                 # copy positions for nodes that still exist
@@ -1136,8 +1181,10 @@ def plot_edit_path(graphs, edit_ops, output=None, show_labels=True, one_fig_per_
                 op = edit_ops[i] if i < len(edit_ops) else None
                 title = None if i < len(edit_ops) else f"Target Graph"
 
-                # derive positions for this subplot, reusing prev_pos where possible
-                if i == 0:
+                # derive positions for this subplot: precomputed layout, else reuse prev_pos where possible
+                if layouts is not None and i < len(layouts):
+                    pos_for_subplot = layouts[i]
+                elif i == 0:
                     pos_for_subplot = compute_layout(data)
                 else:
                     pos_for_subplot = {n: prev_pos[n] for n in G_i.nodes() if prev_pos is not None and n in prev_pos}
@@ -6,31 +6,150 @@
 #define GEDPATHS_ANALYZE_EDIT_PATH_GRAPHS_H
 
 #include <numeric>
+#include <array>
 #include <cmath>
+#include <functional>
+#include <random>
 #include <limits>
 #include <tuple>
 #include <iostream>
 #include <vector>
 #include <map>
+#include <optional>
 #include <fstream>
 #include <filesystem>
 #include <sstream>
 #include <libGraph.h>
+#include "src/perf_counters.h"
+#include "src/bgf_index.h"
 
-struct BucketOperations {
-    unsigned long _node_insertions = 0;
-    unsigned long _node_deletions = 0;
-    unsigned long _node_relabels = 0;
-    unsigned long _edge_insertions = 0;
-    unsigned long _edge_deletions = 0;
-    unsigned long _edge_relabels = 0;
+// Ratio sum(y) / sum(m) over the sampled units (edit paths), e.g. the average number of nodes per graph with y the
+// nodes of all graphs of a path and m the number of graphs of the path. The confidence interval uses the linearized
+// variance of the ratio estimator for a simple random sample of paths drawn without replacement.
+struct RatioEstimator {
+    double n = 0.0;
+    double sum_y = 0.0;
+    double sum_m = 0.0;
+    double sum_yy = 0.0;
+    double sum_mm = 0.0;
+    double sum_ym = 0.0;
+
+    void Add(double y, double m) {
+        n += 1.0;
+        sum_y += y;
+        sum_m += m;
+        sum_yy += y * y;
+        sum_mm += m * m;
+        sum_ym += y * m;
+    }
+    [[nodiscard]] double Estimate() const { return sum_m == 0.0 ? 0.0 : sum_y / sum_m; }
+    // half width of the confidence interval (z = 1.96 for 95%) with finite population correction
+    [[nodiscard]] double HalfWidth(size_t population_units, double z = 1.96) const {
+        if (n < 2.0 || sum_m == 0.0) {
+            return 0.0;
+        }
+        const double r = Estimate();
+        const double mean_m = sum_m / n;
+        const double residual_variance = std::max(0.0, (sum_yy - 2.0 * r * sum_ym + r * r * sum_mm) / (n - 1.0));
+        const double fpc = population_units > 0 ? std::max(0.0, 1.0 - n / static_cast<double>(population_units)) : 1.0;
+        return z * std::sqrt(fpc * residual_variance / n) / mean_m;
+    }
+};
+
+// Operation types counted per position bucket, in the order of POSITION_OPERATION_NAMES
+constexpr size_t POSITION_OPERATION_NUM = 6;
+constexpr std::array<const char*, POSITION_OPERATION_NUM> POSITION_OPERATION_NAMES = {"Node Insertions", "Node Deletions", "Node Relabels", "Edge Insertions", "Edge Deletions", "Edge Relabels"};
+// number of equally sized parts an edit path is split into for the position distributions
+constexpr unsigned long POSITION_BUCKETS = 10;
+
+inline int PositionOperationIndex(const EditOperation& op) {
+    const int object_offset = op.operationObject == OperationObject::NODE ? 0 : op.operationObject == OperationObject::EDGE ? 3 : -1;
+    if (object_offset < 0) {
+        return -1;
+    }
+    switch (op.type) {
+        case EditType::INSERT: return object_offset;
+        case EditType::DELETE: return object_offset + 1;
+        case EditType::RELABEL: return object_offset + 2;
+        default: return -1;
+    }
+}
+
+// Size and connectivity of one graph of an edit path
+struct PathGraphInfo {
+    INDEX nodes = 0;
+    INDEX edges = 0;
+    bool connected = true;
 };
 
+// Connectivity of a graph read from a .bgf file (graphs with less than two nodes count as connected)
+inline bool IsConnected(const StoredGraph& graph) {
+    if (graph.nodes() < 2) {
+        return true;
+    }
+    std::vector<INDEX> parent(graph.nodes());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](INDEX node) {
+        while (parent[node] != node) {
+            node = parent[node] = parent[parent[node]];
+        }
+        return node;
+    };
+    INDEX components = graph.nodes();
+    for (const auto& edge : graph.edges) {
+        const INDEX a = find(edge.source);
+        const INDEX b = find(edge.target);
+        if (a != b) {
+            parent[a] = b;
+            --components;
+        }
+    }
+    return components == 1;
+}
+
+// One edit path of an edit path file: source and target graph, index of its first graph and its operations
+struct EditPathRecord {
+    INDEX source_id = 0;
+    INDEX target_id = 0;
+    INDEX first_graph = 0;
+    std::vector<EditOperation> operations;
+};
+
+// Group the edit path info by (source, target). The graphs of a path are stored consecutively (source graph and
+// one graph per operation), so the offset of each path follows from the info alone.
+inline std::vector<EditPathRecord> EditPathRecords(const std::vector<std::tuple<INDEX, INDEX, INDEX, EditOperation>>& edit_path_info) {
+    std::map<std::pair<INDEX, INDEX>, EditPathRecord> paths;
+    INDEX position = -1;
+    for (const auto& entry : edit_path_info) {
+        INDEX source_id = std::get<0>(entry);
+        INDEX step_id = std::get<1>(entry);
+        INDEX target_id = std::get<2>(entry);
+        auto& path = paths[{source_id, target_id}];
+        if (step_id == 0) {
+            ++position;
+            path.source_id = source_id;
+            path.target_id = target_id;
+            path.first_graph = position;
+        }
+        ++position;
+        path.operations.push_back(std::get<3>(entry));
+    }
+    std::vector<EditPathRecord> records;
+    records.reserve(paths.size());
+    for (auto& [key, path] : paths) {
+        records.emplace_back(std::move(path));
+    }
+    return records;
+}
+
 // Statistic class for num, average, stddev, min, max of a list of values with name
 class ValueStatistics {
 public:
     ValueStatistics()= default;
     explicit ValueStatistics(const std::string& name, const std::vector<double>& values);
+    // Estimate from a sample of population_units units (edit paths). unit_sizes gives the number of consecutive
+    // values belonging to each sampled unit (empty if every value is its own unit). The average gets a 95% confidence interval.
+    ValueStatistics(const std::string& name, const std::vector<double>& values, size_t population_units, const std::vector<size_t>& unit_sizes = {});
     void PrintStatistics() const;
     // Write the stored values to a CSV file in the provided directory.
     // The filename is derived from the statistic name (spaces replaced with underscores).
@@ -44,6 +163,11 @@ private:
     double _stddev = 0.0;
     double _min = std::numeric_limits<double>::max();
     double _max = std::numeric_limits<double>::min();
+    // sampled statistics only
+    bool _sampled = false;
+    size_t _sample_units = 0;
+    size_t _population_units = 0;
+    double _ci_half_width = 0.0;
 };
 
 ValueStatistics::ValueStatistics(const std::string &name, const std::vector<double> &values) {
@@ -70,13 +194,40 @@ ValueStatistics::ValueStatistics(const std::string &name, const std::vector<doub
     }
 }
 
+ValueStatistics::ValueStatistics(const std::string &name, const std::vector<double> &values, size_t population_units, const std::vector<size_t> &unit_sizes)
+    : ValueStatistics(name, values) {
+    _sampled = true;
+    _population_units = population_units;
+    RatioEstimator estimator;
+    if (unit_sizes.empty()) {
+        for (const auto& value : values) {
+            estimator.Add(value, 1.0);
+        }
+    }
+    else {
+        size_t offset = 0;
+        for (const size_t unit_size : unit_sizes) {
+            const double unit_sum = std::accumulate(values.begin() + offset, values.begin() + offset + unit_size, 0.0);
+            estimator.Add(unit_sum, static_cast<double>(unit_size));
+            offset += unit_size;
+        }
+    }
+    _sample_units = static_cast<size_t>(estimator.n);
+    _ci_half_width = estimator.HalfWidth(population_units);
+}
+
 void ValueStatistics::PrintStatistics() const {
     std::cout << "Statistics for " << _name << ":\n";
     std::cout << "  Number of values: " << _num_values << "\n";
-    std::cout << "  Average: " << _average << "\n";
+    std::cout << "  Average: " << _average;
+    if (_sampled) {
+        std::cout << " (95% CI [" << _average - _ci_half_width << ", " << _average + _ci_half_width << "], "
+                  << _sample_units << " of " << _population_units << " paths)";
+    }
+    std::cout << "\n";
     std::cout << "  Standard Deviation: " << _stddev << "\n";
-    std::cout << "  Minimum: " << _min << "\n";
-    std::cout << "  Maximum: " << _max << "\n";
+    std::cout << "  Minimum: " << _min << (_sampled ? " (in sample)" : "") << "\n";
+    std::cout << "  Maximum: " << _max << (_sampled ? " (in sample)" : "") << "\n";
 }
 
 void ValueStatistics::WriteCSV(const std::string &output_dir) const {
@@ -111,18 +262,36 @@ void ValueStatistics::WriteCSV(const std::string &output_dir) const {
 
 
 
+// Number of paths to sample for -sample_paths / -sample_fraction, 0 if all paths are analyzed
+inline size_t path_sample_size(size_t num_paths, size_t sample_paths, double sample_fraction) {
+    if (sample_paths > 0) {
+        return std::min(sample_paths, num_paths);
+    }
+    if (sample_fraction > 0.0 && sample_fraction < 1.0) {
+        return std::max<size_t>(1, static_cast<size_t>(std::ceil(sample_fraction * static_cast<double>(num_paths))));
+    }
+    return 0;
+}
+
 // Statistic class for edit paths
 class EditPathStatistics {
 public:
     EditPathStatistics()= default;
     explicit EditPathStatistics(const GraphData<UDataGraph>& edit_paths, const std::vector<std::tuple<INDEX, INDEX, INDEX, EditOperation>>& edit_path_info);
+    // Estimate the statistics from paths drawn uniformly without replacement (sample_paths paths or a sample_fraction
+    // of all paths), only the graphs of the sampled paths are read from the file. std::nullopt if a graph cannot be read.
+    static std::optional<EditPathStatistics> Sample(const BGFIndex& edit_paths, const std::vector<std::tuple<INDEX, INDEX, INDEX, EditOperation>>& edit_path_info, size_t sample_paths, double sample_fraction, int seed);
     void PrintStatistics() const;
     // Write all contained ValueStatistics to CSV files inside the provided directory.
     void WriteCSVFiles(const std::string& output_dir) const;
     void WritePositionCSVFiles(const std::string& output_dir) const;
 private:
-    GraphData<UDataGraph> _edit_paths;
+    // statistics over the given paths, graph_info returns size and connectivity of a graph by its index in the edit path
+    // file (std::nullopt if the graph cannot be read, then Compute stops and returns false)
+    bool Compute(const std::vector<EditPathRecord>& paths, const std::function<std::optional<PathGraphInfo>(INDEX)>& graph_info, size_t population_paths);
     std::vector<std::tuple<INDEX, INDEX, INDEX, EditOperation>> _edit_path_info;
+    // 0 if the statistics are exact, otherwise the number of paths the sample was drawn from
+    size_t _population_paths = 0;
     ValueStatistics _num_nodes_stats;
     ValueStatistics _num_edges_stats;
     ValueStatistics _num_operations_stats;
@@ -134,6 +303,8 @@ private:
     ValueStatistics _edge_deletions_stats;
     ValueStatistics _edge_relabels_stats;
     ValueStatistics _connectedness_stats;
+    // Share of each operation type per position bucket: y = operations of the type in the bucket, m = operations of the type per path
+    std::array<std::array<RatioEstimator, POSITION_BUCKETS>, POSITION_OPERATION_NUM> _position_buckets{};
     // Per-path position lists (each inner vector corresponds to one edit path and stores positions/indexes where that operation occurred)
     std::vector<std::vector<int>> _node_insertion_positions;
     std::vector<std::vector<int>> _node_deletion_positions;
@@ -144,7 +315,44 @@ private:
 };
 
 EditPathStatistics::EditPathStatistics(const GraphData<UDataGraph> &edit_paths, const std::vector<std::tuple<INDEX, INDEX, INDEX, EditOperation>> &edit_path_info)
-    : _edit_paths(edit_paths), _edit_path_info(edit_path_info) {
+    : _edit_path_info(edit_path_info) {
+    const std::vector<EditPathRecord> paths = EditPathRecords(_edit_path_info);
+    for (const auto& path : paths) {
+        // print name
+        std::cout << "Processing edit paths for source graph: " << edit_paths.graphData[path.first_graph].GetName() << std::endl;
+    }
+    Compute(paths, [&edit_paths](INDEX graph_index) {
+        const UDataGraph& g = edit_paths.graphData[graph_index];
+        return std::optional(PathGraphInfo{g.nodes(), g.edges(), g.GetConnectivity()});
+    }, 0);
+}
+
+std::optional<EditPathStatistics> EditPathStatistics::Sample(const BGFIndex &edit_paths, const std::vector<std::tuple<INDEX, INDEX, INDEX, EditOperation>> &edit_path_info, size_t sample_paths, double sample_fraction, int seed) {
+    EditPathStatistics stats;
+    stats._edit_path_info = edit_path_info;
+    const std::vector<EditPathRecord> paths = EditPathRecords(stats._edit_path_info);
+    std::vector<EditPathRecord> sample;
+    std::sample(paths.begin(), paths.end(), std::back_inserter(sample), path_sample_size(paths.size(), sample_paths, sample_fraction), std::mt19937(seed));
+    // read the sampled graphs front to back
+    std::ranges::sort(sample, {}, &EditPathRecord::first_graph);
+    std::cout << "Sampled " << sample.size() << " of " << paths.size() << " edit paths" << std::endl;
+    // node and edge counts are part of the file headers, only the connectivity needs the edges of the sampled graphs
+    const bool read = stats.Compute(sample, [&edit_paths](INDEX graph_index) -> std::optional<PathGraphInfo> {
+        const auto& entry = edit_paths.entry(graph_index);
+        StoredGraph graph;
+        if (!edit_paths.ReadGraph(graph_index, graph)) {
+            return std::nullopt;
+        }
+        return PathGraphInfo{entry.nodes, entry.edges, IsConnected(graph)};
+    }, paths.size());
+    if (!read) {
+        return std::nullopt;
+    }
+    return stats;
+}
+
+bool EditPathStatistics::Compute(const std::vector<EditPathRecord> &paths, const std::function<std::optional<PathGraphInfo>(INDEX)> &graph_info, size_t population_paths) {
+    _population_paths = population_paths;
     std::vector<double> num_nodes;
     std::vector<double> num_edges;
     std::vector<double> num_operations;
@@ -156,141 +364,127 @@ EditPathStatistics::EditPathStatistics(const GraphData<UDataGraph> &edit_paths,
     std::vector<double> edge_deletions;
     std::vector<double> edge_relabels;
     std::vector<double> graphs_unconnected;
-    const unsigned long bucket_size = 10;
-    std::vector<BucketOperations> buckets ( bucket_size );
-
-    // Map to count operations per (source_id, target_id)
-    std::map<std::pair<INDEX, INDEX>, std::vector<EditOperation>> operations_map;
-    std::map<std::pair<INDEX, INDEX>, std::pair<INDEX, INDEX>> graph_positions_map;
-    INDEX position = -1;
-    for (const auto& entry : _edit_path_info) {
-        INDEX source_id = std::get<0>(entry);
-        INDEX step_id = std::get<1>(entry);
-        INDEX target_id = std::get<2>(entry);
-        if (step_id == 0) {
-            ++position;
-            auto source_graph = &_edit_paths.graphData[position];
-            std::string source_graph_name = source_graph->GetName();
-            // print name
-            std::cout << "Processing edit paths for source graph: " << source_graph_name << std::endl;
-            graph_positions_map[{source_id, target_id}] = {position, position + 1};
-        }
-        else {
-            graph_positions_map[{source_id, std::get<2>(entry)}].second += 1;
-        }
-        ++position;
+    // number of graphs per path (the per-graph statistics are clustered by path)
+    std::vector<size_t> path_graph_counts;
 
-        EditOperation operation = std::get<3>(entry);
-        operations_map[{source_id, target_id}].push_back(operation);
-    }
-
-    // Now calculate statistics based on operations_map
-    for (const auto& [key, operations] : operations_map) {
-        INDEX source_id = key.first;
-        INDEX target_id = key.second;
-
-        // Find all graphs corresponding to the current path order in operations_map is the same as in edit_paths
-        std::vector<UDataGraph*> path_graphs = std::vector<UDataGraph*>(operations.size() + 1, nullptr);
-        for (INDEX i = 0; i < path_graphs.size(); ++i) {
-            INDEX graph_index = graph_positions_map[{source_id, target_id}].first;
-            path_graphs[i] = &_edit_paths.graphData[graph_index + i];
+    // Now calculate statistics based on the paths
+    for (const auto& path : paths) {
+        const auto& operations = path.operations;
+        // the source graph and one graph per operation
+        const INDEX path_graphs = operations.size() + 1;
+        path_graph_counts.push_back(path_graphs);
+        graphs_unconnected.push_back(0.0);
+        for (INDEX i = 0; i < path_graphs; ++i) {
+            const std::optional<PathGraphInfo> info = graph_info(path.first_graph + i);
+            if (!info) {
+                return false;
+            }
+            const PathGraphInfo& g = *info;
+            num_nodes.push_back(static_cast<double>(g.nodes));
+            num_edges.push_back(static_cast<double>(g.edges));
+            if (!g.connected) {
+                graphs_unconnected.back() += 1.0;
+            }
         }
+        node_insertions.push_back(0.0);
+        node_deletions.push_back(0.0);
+        node_relabels.push_back(0.0);
+        edge_insertions.push_back(0.0);
+        edge_deletions.push_back(0.0);
+        edge_relabels.push_back(0.0);
 
-        if (!path_graphs.empty()) {
-            graphs_unconnected.push_back(0.0);
-            for (const auto& g : path_graphs) {
-                if (g == nullptr) continue;
-                num_nodes.push_back(static_cast<double>(g->nodes()));
-                num_edges.push_back(static_cast<double>(g->edges()));
-                // print whether the graph is connected
-                std::string graph_name = g->GetName();
-                bool connected = g->GetConnectivity();
-                if (!connected) {
-                    graphs_unconnected.back() += 1.0;
-                }
+        std::array<std::array<double, POSITION_BUCKETS>, POSITION_OPERATION_NUM> path_buckets{};
+        unsigned long bucket_counter = 0;
+        unsigned long operation_counter = 0;
+        // per-path positional lists for this path
+        std::vector<int> node_insert_pos;
+        std::vector<int> node_delete_pos;
+        std::vector<int> node_relabel_pos;
+        std::vector<int> edge_insert_pos;
+        std::vector<int> edge_delete_pos;
+        std::vector<int> edge_relabel_pos;
+        for (const auto& op : operations) {
+            // make divisor explicit as double to avoid narrowing warnings
+            auto ops_size_d = static_cast<double>(operations.size());
+            double bucket_divisor = ops_size_d / static_cast<double>(POSITION_BUCKETS);
+            bucket_counter = std::min(static_cast<unsigned long>(std::floor(static_cast<double>(operation_counter) / bucket_divisor)), POSITION_BUCKETS - 1);
+            if (const int operation_index = PositionOperationIndex(op); operation_index >= 0) {
+                path_buckets[operation_index][bucket_counter] += 1.0;
             }
-            node_insertions.push_back(0.0);
-            node_deletions.push_back(0.0);
-            node_relabels.push_back(0.0);
-            edge_insertions.push_back(0.0);
-            edge_deletions.push_back(0.0);
-            edge_relabels.push_back(0.0);
-
-            unsigned long bucket_counter = 0;
-            unsigned long operation_counter = 0;
-            // per-path positional lists for this path
-            std::vector<int> node_insert_pos;
-            std::vector<int> node_delete_pos;
-            std::vector<int> node_relabel_pos;
-            std::vector<int> edge_insert_pos;
-            std::vector<int> edge_delete_pos;
-            std::vector<int> edge_relabel_pos;
-            for (const auto& op : operations) {
-                // make divisor explicit as double to avoid narrowing warnings
-                auto ops_size_d = static_cast<double>(operations.size());
-                double bucket_divisor = ops_size_d / static_cast<double>(bucket_size);
-                bucket_counter = std::min(static_cast<unsigned long>(std::floor(static_cast<double>(operation_counter) / bucket_divisor)), bucket_size - 1);
-                switch (op.operationObject) {
-                    case OperationObject::NODE:
-                        if (op.type == EditType::INSERT) {
-                            node_insertions.back() += 1.0;
-                            node_insert_pos.push_back(static_cast<int>(operation_counter));
-                            buckets[bucket_counter]._node_insertions += 1;
-                        } else if (op.type == EditType::DELETE) {
-                            node_deletions.back() += 1.0;
-                            node_delete_pos.push_back(static_cast<int>(operation_counter));
-                            buckets[bucket_counter]._node_deletions += 1;
-                        } else if (op.type == EditType::RELABEL) {
-                            node_relabels.back() += 1.0;
-                            node_relabel_pos.push_back(static_cast<int>(operation_counter));
-                            buckets[bucket_counter]._node_relabels += 1;
-                        }
-                        break;
-                    case OperationObject::EDGE:
-                        if (op.type == EditType::INSERT) {
-                            edge_insertions.back() += 1.0;
-                            edge_insert_pos.push_back(static_cast<int>(operation_counter));
-                            buckets[bucket_counter]._edge_insertions += 1;
-                        } else if (op.type == EditType::DELETE) {
-                            edge_deletions.back() += 1.0;
-                            edge_delete_pos.push_back(static_cast<int>(operation_counter));
-                            buckets[bucket_counter]._edge_deletions += 1;
-                        } else if (op.type == EditType::RELABEL) {
-                            edge_relabels.back() += 1.0;
-                            edge_relabel_pos.push_back(static_cast<int>(operation_counter));
-                            buckets[bucket_counter]._edge_relabels += 1;
-                        }
-                        break;
-                    default:
-                        break;
-                }
-                operation_counter += 1;
+            switch (op.operationObject) {
+                case OperationObject::NODE:
+                    if (op.type == EditType::INSERT) {
+                        node_insertions.back() += 1.0;
+                        node_insert_pos.push_back(static_cast<int>(operation_counter));
+                    } else if (op.type == EditType::DELETE) {
+                        node_deletions.back() += 1.0;
+                        node_delete_pos.push_back(static_cast<int>(operation_counter));
+                    } else if (op.type == EditType::RELABEL) {
+                        node_relabels.back() += 1.0;
+                        node_relabel_pos.push_back(static_cast<int>(operation_counter));
+                    }
+                    break;
+                case OperationObject::EDGE:
+                    if (op.type == EditType::INSERT) {
+                        edge_insertions.back() += 1.0;
+                        edge_insert_pos.push_back(static_cast<int>(operation_counter));
+                    } else if (op.type == EditType::DELETE) {
+                        edge_deletions.back() += 1.0;
+                        edge_delete_pos.push_back(static_cast<int>(operation_counter));
+                    } else if (op.type == EditType::RELABEL) {
+                        edge_relabels.back() += 1.0;
+                        edge_relabel_pos.push_back(static_cast<int>(operation_counter));
+                    }
+                    break;
+                default:
+                    break;
             }
-            // store per-path positions into the global vectors
-            _node_insertion_positions.push_back(std::move(node_insert_pos));
-            _node_deletion_positions.push_back(std::move(node_delete_pos));
-            _node_relabel_positions.push_back(std::move(node_relabel_pos));
-            _edge_insertion_positions.push_back(std::move(edge_insert_pos));
-            _edge_deletion_positions.push_back(std::move(edge_delete_pos));
-            _edge_relabel_positions.push_back(std::move(edge_relabel_pos));
-            num_operations.push_back(static_cast<double>(operations.size()));
-            path_lengths.push_back(static_cast<double>(operations.size()));
+            operation_counter += 1;
         }
+        for (size_t type = 0; type < POSITION_OPERATION_NUM; ++type) {
+            const double type_operations = std::accumulate(path_buckets[type].begin(), path_buckets[type].end(), 0.0);
+            for (size_t bucket = 0; bucket < POSITION_BUCKETS; ++bucket) {
+                _position_buckets[type][bucket].Add(path_buckets[type][bucket], type_operations);
+            }
+        }
+        // store per-path positions into the global vectors
+        _node_insertion_positions.push_back(std::move(node_insert_pos));
+        _node_deletion_positions.push_back(std::move(node_delete_pos));
+        _node_relabel_positions.push_back(std::move(node_relabel_pos));
+        _edge_insertion_positions.push_back(std::move(edge_insert_pos));
+        _edge_deletion_positions.push_back(std::move(edge_delete_pos));
+        _edge_relabel_positions.push_back(std::move(edge_relabel_pos));
+        num_operations.push_back(static_cast<double>(operations.size()));
+        path_lengths.push_back(static_cast<double>(operations.size()));
     }
 
-    _num_nodes_stats = ValueStatistics("Number of Nodes", num_nodes);
-    _num_edges_stats = ValueStatistics("Number of Edges", num_edges);
-    _num_operations_stats = ValueStatistics("Number of Operations", num_operations);
-    _path_length_stats = ValueStatistics("Path Length", path_lengths);
-    _node_insertions_stats = ValueStatistics("Node Insertions", node_insertions);
-    _node_deletions_stats = ValueStatistics("Node Deletions", node_deletions);
-    _node_relabels_stats = ValueStatistics("Node Relabels", node_relabels);
-    _edge_insertions_stats = ValueStatistics("Edge Insertions", edge_insertions);
-    _edge_deletions_stats = ValueStatistics("Edge Deletions", edge_deletions);
-    _edge_relabels_stats = ValueStatistics("Edge Relabels", edge_relabels);
-    _connectedness_stats = ValueStatistics("Graphs Unconnected", graphs_unconnected);
-
-
+    if (population_paths == 0) {
+        _num_nodes_stats = ValueStatistics("Number of Nodes", num_nodes);
+        _num_edges_stats = ValueStatistics("Number of Edges", num_edges);
+        _num_operations_stats = ValueStatistics("Number of Operations", num_operations);
+        _path_length_stats = ValueStatistics("Path Length", path_lengths);
+        _node_insertions_stats = ValueStatistics("Node Insertions", node_insertions);
+        _node_deletions_stats = ValueStatistics("Node Deletions", node_deletions);
+        _node_relabels_stats = ValueStatistics("Node Relabels", node_relabels);
+        _edge_insertions_stats = ValueStatistics("Edge Insertions", edge_insertions);
+        _edge_deletions_stats = ValueStatistics("Edge Deletions", edge_deletions);
+        _edge_relabels_stats = ValueStatistics("Edge Relabels", edge_relabels);
+        _connectedness_stats = ValueStatistics("Graphs Unconnected", graphs_unconnected);
+    }
+    else {
+        _num_nodes_stats = ValueStatistics("Number of Nodes", num_nodes, population_paths, path_graph_counts);
+        _num_edges_stats = ValueStatistics("Number of Edges", num_edges, population_paths, path_graph_counts);
+        _num_operations_stats = ValueStatistics("Number of Operations", num_operations, population_paths);
+        _path_length_stats = ValueStatistics("Path Length", path_lengths, population_paths);
+        _node_insertions_stats = ValueStatistics("Node Insertions", node_insertions, population_paths);
+        _node_deletions_stats = ValueStatistics("Node Deletions", node_deletions, population_paths);
+        _node_relabels_stats = ValueStatistics("Node Relabels", node_relabels, population_paths);
+        _edge_insertions_stats = ValueStatistics("Edge Insertions", edge_insertions, population_paths);
+        _edge_deletions_stats = ValueStatistics("Edge Deletions", edge_deletions, population_paths);
+        _edge_relabels_stats = ValueStatistics("Edge Relabels", edge_relabels, population_paths);
+        _connectedness_stats = ValueStatistics("Graphs Unconnected", graphs_unconnected, population_paths);
+    }
+    return true;
 }
 void EditPathStatistics::PrintStatistics() const {
     std::cout << "Edit Path Statistics:\n";
@@ -305,6 +499,21 @@ void EditPathStatistics::PrintStatistics() const {
     _edge_deletions_stats.PrintStatistics();
     _edge_relabels_stats.PrintStatistics();
     _connectedness_stats.PrintStatistics();
+    std::cout << "Operation positions (share of each operation type per tenth of the path";
+    if (_population_paths > 0) {
+        std::cout << ", +- half width of the 95% CI";
+    }
+    std::cout << "):\n";
+    for (size_t type = 0; type < POSITION_OPERATION_NUM; ++type) {
+        std::cout << "  " << POSITION_OPERATION_NAMES[type] << ":";
+        for (const auto& bucket : _position_buckets[type]) {
+            std::cout << " " << bucket.Estimate();
+            if (_population_paths > 0) {
+                std::cout << "+-" << bucket.HalfWidth(_population_paths);
+            }
+        }
+        std::cout << "\n";
+    }
 }
 
 void EditPathStatistics::WriteCSVFiles(const std::string &output_dir) const {
@@ -355,21 +564,62 @@ void EditPathStatistics::WritePositionCSVFiles(const std::string &output_dir) co
     WritePositionsCSVFile(output_dir, "Edge_Insertions_Positions", _edge_insertion_positions);
     WritePositionsCSVFile(output_dir, "Edge_Deletions_Positions", _edge_deletion_positions);
     WritePositionsCSVFile(output_dir, "Edge_Relabels_Positions", _edge_relabel_positions);
+
+    // share of each operation type per position bucket (with the confidence interval if the paths were sampled)
+    std::ostringstream path;
+    path << output_dir; if (!output_dir.empty() && output_dir.back() != '/') path << '/';
+    path << "Position_Buckets.csv";
+    std::ofstream ofs(path.str());
+    if (!ofs.is_open()) { std::cerr << "Failed to write positions CSV: " << path.str() << std::endl; return; }
+    ofs << "operation,bucket,share,ci_low,ci_high\n";
+    for (size_t type = 0; type < POSITION_OPERATION_NUM; ++type) {
+        for (size_t bucket = 0; bucket < POSITION_BUCKETS; ++bucket) {
+            const auto& estimator = _position_buckets[type][bucket];
+            const double half_width = _population_paths > 0 ? estimator.HalfWidth(_population_paths) : 0.0;
+            ofs << POSITION_OPERATION_NAMES[type] << "," << bucket << "," << estimator.Estimate() << ","
+                << estimator.Estimate() - half_width << "," << estimator.Estimate() + half_width << "\n";
+        }
+    }
 }
 
 
 inline int analyze_edit_path_graphs(const std::string& db,
                                     const std::string& edit_path_output,
-                                    const std::string& method) {
+                                    const std::string& method,
+                                    size_t sample_paths = 0,
+                                    double sample_fraction = 1.0,
+                                    int seed = 42) {
     std::string edit_path_output_db = edit_path_output + method + "/" + db + "/";
 
     // Load MUTAG edit paths
-    GraphData<UDataGraph> edit_paths;
+    ScopedPerfStage load_stage("load_paths");
     std::vector<std::tuple<INDEX, INDEX, INDEX, EditOperation>> edit_path_info;
-    edit_paths.Load(edit_path_output_db + db + "_edit_paths.bgf");
     std::string info_path = edit_path_output_db + db + "_edit_paths_data.bin";
     ReadEditPathInfo(info_path, edit_path_info);
-    EditPathStatistics stats(edit_paths, edit_path_info);
+    EditPathStatistics stats;
+    if (sample_paths > 0 || (sample_fraction > 0.0 && sample_fraction < 1.0)) {
+        // approximate statistics: index the edit path file and read only the graphs of the sampled paths
+        // only the structure of the graphs is needed, not their labels
+        const auto index = BGFIndex::Open(edit_path_output_db + db + "_edit_paths.bgf", false);
+        if (!index) {
+            return 1;
+        }
+        load_stage.Stop();
+        ScopedPerfStage statistics_stage("path_statistics");
+        auto sampled = EditPathStatistics::Sample(*index, edit_path_info, sample_paths, sample_fraction, seed);
+        if (!sampled) {
+            std::cerr << "Could not read the sampled edit path graphs from " << index->path() << std::endl;
+            return 1;
+        }
+        stats = std::move(*sampled);
+    }
+    else {
+        GraphData<UDataGraph> edit_paths;
+        edit_paths.Load(edit_path_output_db + db + "_edit_paths.bgf");
+        load_stage.Stop();
+        ScopedPerfStage statistics_stage("path_statistics");
+        stats = EditPathStatistics(edit_paths, edit_path_info);
+    }
     stats.PrintStatistics();
 
     // Write evaluation CSVs under Results/Paths/<method>/<db>/Evaluation/ create directory if it does not exist
@@ -377,6 +627,7 @@ inline int analyze_edit_path_graphs(const std::string& db,
     if (!std::filesystem::exists(eval_dir)) {
         std::filesystem::create_directory(eval_dir);
     }
+    ScopedPerfStage write_stage("write_evaluation");
     stats.WriteCSVFiles(eval_dir);
     // Write per-path positions evaluation CSVs
     stats.WritePositionCSVFiles(eval_dir);
@@ -15,6 +15,10 @@
 #include <string>
 #include <algorithm>
 #include <libGraph.h>
+#include "src/perf_counters.h"
+#include "src/mapping_store.h"
+#include "src/bgf_index.h"
+#include "src/graph_features.h"
 
 // helper for pair hash
 struct PairHash {
@@ -58,27 +62,233 @@ inline void print_stats(const std::string& name, const Stats& s) {
     std::cout << "  Max: " << s.max << "\n";
 }
 
+using DistanceMap = std::unordered_map<std::pair<INDEX, INDEX>, double, PairHash>;
+
+// Statistics of the distance differences of the pairs in both maps, optionally written as CSV
+inline int compare_distances(const std::string& db, const DistanceMap& map_a, const DistanceMap& map_b,
+                             const std::string& method, const std::string& compare_method, const std::string& csv_out) {
+    // gather pairs present in both
+    std::vector<double> paired_a;
+    std::vector<double> paired_b;
+    paired_a.reserve(std::min(map_a.size(), map_b.size()));
+    paired_b.reserve(std::min(map_a.size(), map_b.size()));
+    for (const auto &kv : map_a) {
+        auto key = kv.first;
+        auto it = map_b.find(key);
+        if (it != map_b.end()) {
+            paired_a.push_back(kv.second);
+            paired_b.push_back(it->second);
+        }
+    }
+    std::cout << "Found " << paired_a.size() << " common graph pairs between methods.\n";
+    if (paired_a.empty()) {
+        std::cerr << "No overlapping pairs to compare.\n";
+        return 4;
+    }
+
+    // compute diff statistics
+    std::vector<double> diffs; diffs.reserve(paired_a.size());
+    for (size_t i = 0; i < paired_a.size(); ++i) diffs.push_back(paired_a[i] - paired_b[i]);
+    Stats stats_b = compute_stats(paired_b);
+    Stats stats_diff = compute_stats(diffs);
+    print_stats(compare_method + " (" + db + ")", stats_b);
+    print_stats(std::string("Difference (") + method + " - " + compare_method + ")", stats_diff);
+
+    // optional CSV output
+    if (!csv_out.empty()) {
+        std::ofstream ofs(csv_out);
+        if (!ofs.is_open()) {
+            std::cerr << "Failed to open CSV output: " << csv_out << "\n";
+        } else {
+            ofs << "id1,id2," << method << "," << compare_method << ",diff\n";
+            for (const auto &kv : map_a) {
+                auto key = kv.first;
+                auto it = map_b.find(key);
+                if (it != map_b.end()) {
+                    ofs << key.first << "," << key.second << "," << kv.second << "," << it->second << "," << (kv.second - it->second) << "\n";
+                }
+            }
+            ofs.close();
+            std::cout << "Wrote comparison CSV to " << csv_out << "\n";
+        }
+    }
+    return 0;
+}
+
+// Checks the distances against the graph features of the sidecar written by CreateMappings (skipped if there is none).
+// With positive edit costs only isomorphic graphs have distance 0, so two graphs with different WL hashes need a
+// positive distance. Equal WL hashes with a positive distance hint at isomorphic graphs that the method did not map
+// onto each other (non-isomorphic graphs may share a WL hash, so these are only reported).
+inline void check_distances_with_features(const std::string& db, const std::string& processed_graph_path, const DistanceMap& distances) {
+    GraphFeatures features;
+    if (!GraphFeatures::Load(processed_graph_path, db, features)) {
+        std::cout << "No graph features for " << db << " in " << processed_graph_path << " (written by CreateMappings), skipping the feature check\n";
+        return;
+    }
+    std::vector<std::pair<INDEX, INDEX>> zero_distance_different;
+    size_t equal_hash_positive = 0;
+    for (const auto& [pair, distance] : distances) {
+        if (pair.first >= features.size() || pair.second >= features.size()) {
+            continue;
+        }
+        const bool equal_hash = features.wl_hash(pair.first) == features.wl_hash(pair.second);
+        if (distance == 0.0 && !equal_hash) {
+            zero_distance_different.push_back(pair);
+        }
+        else if (distance > 0.0 && equal_hash) {
+            ++equal_hash_positive;
+        }
+    }
+    if (!zero_distance_different.empty()) {
+        std::ranges::sort(zero_distance_different);
+        std::cerr << "Warning: " << zero_distance_different.size() << " mappings have distance 0 between graphs with different WL hashes:\n";
+        for (size_t i = 0; i < std::min<size_t>(zero_distance_different.size(), 10); ++i) {
+            std::cerr << "  Graph IDs (" << zero_distance_different[i].first << ", " << zero_distance_different[i].second << ")\n";
+        }
+    }
+    std::cout << "Feature check: " << zero_distance_different.size() << " mappings with distance 0 between different graphs, "
+              << equal_hash_positive << " with positive distance between graphs with equal WL hash\n";
+}
+
+// Out-of-core variant (-lazy): the mappings are read through the mapping index and verified in batches of
+// LAZY_VERIFY_BATCH mappings, only the graphs of one batch are read from the preprocessed file at a time.
+// The comparison only needs the distances, it reads the index records of the other method.
+constexpr uint64_t LAZY_VERIFY_BATCH = 10000;
+
+inline int analyze_mappings_lazy(const std::string& db,
+                                 const std::string& processed_graph_path,
+                                 const std::string& mappings_dir_a,
+                                 const std::string& mappings_dir_b,
+                                 const std::string& method,
+                                 const std::string& compare_method,
+                                 const std::string& csv_out) {
+    const auto index_a = MappingIndex::Open(mappings_dir_a, db);
+    if (!index_a) {
+        std::cerr << "-lazy needs the mapping index " << MappingIndexFile(mappings_dir_a, db) << ", run once without -lazy to build it\n";
+        return 2;
+    }
+    const std::string graph_file = processed_graph_path + db + ".bgf";
+    const auto graph_index = BGFIndex::Open(graph_file);
+    if (!graph_index) {
+        std::cerr << "No graphs loaded for db='" << db << "' from '" << processed_graph_path << "'\n";
+        return 1;
+    }
+    std::cout << "Loaded " << index_a->size() << " mappings from " << MappingIndexFile(mappings_dir_a, db) << "\n";
+
+    ScopedPerfStage statistics_stage("statistics");
+    GraphData<UDataGraph> graphs;
+    MappingSummary summary;
+    DistanceMap map_a;
+    std::vector<uint64_t> invalids;
+    for (uint64_t begin = 0; begin < index_a->size(); begin += LAZY_VERIFY_BATCH) {
+        const uint64_t end = std::min(begin + LAZY_VERIFY_BATCH, index_a->size());
+        std::vector<std::pair<INDEX, INDEX>> batch_pairs;
+        for (uint64_t ordinal = begin; ordinal < end; ++ordinal) {
+            batch_pairs.emplace_back(index_a->record(ordinal).source_id, index_a->record(ordinal).target_id);
+        }
+        const std::vector<INDEX> graph_ids = ReferencedGraphIds(batch_pairs);
+        if (!LoadGraphsById(*graph_index, graph_ids, graphs)) {
+            std::cerr << "Could not read the graphs of the mappings from " << graph_file << "\n";
+            return 1;
+        }
+        std::vector<GEDEvaluation<UDataGraph>> batch;
+        batch.reserve(end - begin);
+        for (uint64_t ordinal = begin; ordinal < end; ++ordinal) {
+            batch.emplace_back(index_a->Decode(ordinal, graphs));
+        }
+        const std::vector<char> is_valid = MappingValidity(batch);
+        for (size_t i = 0; i < batch.size(); ++i) {
+            summary.Add(batch[i], is_valid[i]);
+            map_a[batch[i].graph_ids] = batch[i].distance;
+            if (!is_valid[i]) {
+                invalids.push_back(begin + i);
+            }
+        }
+        UnloadGraphsById(graph_ids, graphs);
+    }
+    if (!invalids.empty()) {
+        std::cerr << "Warning: Found invalid mappings for the following mapping index ordinals (these will be skipped):\n";
+        for (const auto ordinal : invalids) {
+            std::cerr << "  " << ordinal << ": " << "Graph IDs (" << index_a->record(ordinal).source_id << ", " << index_a->record(ordinal).target_id << ")\n";
+        }
+    } else {
+        std::cout << "All loaded mappings are valid.\n";
+    }
+    Stats stats_a = compute_stats([&]() {
+        std::vector<double> v; v.reserve(map_a.size());
+        for (const auto &kv : map_a) v.push_back(kv.second);
+        return v;
+    }());
+    print_stats(method + " (" + db + ")", stats_a);
+    WriteMappingSummary(mappings_dir_a, db, summary);
+    check_distances_with_features(db, processed_graph_path, map_a);
+    statistics_stage.Stop();
+
+    if (compare_method.empty()) {
+        return 0;
+    }
+    const auto index_b = MappingIndex::Open(mappings_dir_b, db);
+    if (!index_b) {
+        std::cerr << "Mapping index for compare-method not found: " << MappingIndexFile(mappings_dir_b, db) << "\n";
+        return 3;
+    }
+    ScopedPerfStage compare_stage("compare_mappings");
+    std::cout << "Loaded " << index_b->size() << " mappings from " << MappingIndexFile(mappings_dir_b, db) << "\n";
+    DistanceMap map_b;
+    for (uint64_t ordinal = 0; ordinal < index_b->size(); ++ordinal) {
+        map_b[{index_b->record(ordinal).source_id, index_b->record(ordinal).target_id}] = index_b->record(ordinal).distance;
+    }
+    return compare_distances(db, map_a, map_b, method, compare_method, csv_out);
+}
+
 inline int analyze_mappings(const std::string& db,
                              const std::string& processed_graph_path,
                              const std::string& mappings_root,
                              const std::string& method,
                              const std::string& compare_method = "",
-                             const std::string& csv_out = "") {
+                             const std::string& csv_out = "",
+                             const bool lazy = false) {
         // prepare paths
-    std::string mappings_path_a = mappings_root;
-    if (mappings_path_a.back() != '/') mappings_path_a += '/';
-    mappings_path_a += method + "/" + db + "/" + db + "_ged_mapping.bin";
+    std::string mappings_dir_a = mappings_root;
+    if (mappings_dir_a.back() != '/') mappings_dir_a += '/';
+    mappings_dir_a += method + "/" + db + "/";
+    const std::string mappings_path_a = MappingFile(mappings_dir_a, db);
+
+    // plain summaries are maintained in the metadata of the mapping store and the feature check only needs the distances,
+    // which the mapping index holds. The mappings themselves are only needed for comparisons and the validity check of -lazy.
+    if (compare_method.empty() && !lazy) {
+        MappingSummary summary;
+        const auto index = MappingIndex::Open(mappings_dir_a, db);
+        if (index && ReadMappingSummary(mappings_dir_a, db, summary)) {
+            std::cout << "Read summary of " << summary.count() << " mappings from " << MappingMetaFile(mappings_dir_a, db) << "\n";
+            summary.Print(method + " (" + db + ")");
+            DistanceMap distances;
+            for (uint64_t ordinal = 0; ordinal < index->size(); ++ordinal) {
+                distances[{index->record(ordinal).source_id, index->record(ordinal).target_id}] = index->record(ordinal).distance;
+            }
+            check_distances_with_features(db, processed_graph_path, distances);
+            return 0;
+        }
+    }
 
+    std::string mappings_dir_b;
     std::string mappings_path_b;
     if (!compare_method.empty()) {
-        mappings_path_b = mappings_root;
-        if (mappings_path_b.back() != '/') mappings_path_b += '/';
-        mappings_path_b += compare_method + "/" + db + "/" + db + "_ged_mapping.bin";
+        mappings_dir_b = mappings_root;
+        if (mappings_dir_b.back() != '/') mappings_dir_b += '/';
+        mappings_dir_b += compare_method + "/" + db + "/";
+        mappings_path_b = MappingFile(mappings_dir_b, db);
+    }
+
+    if (lazy) {
+        return analyze_mappings_lazy(db, processed_graph_path, mappings_dir_a, mappings_dir_b, method, compare_method, csv_out);
     }
 
     // Load graphs (function returns void in this codebase; mimic usage in other tools)
+    ScopedPerfStage load_stage("load_graphs");
     GraphData<UDataGraph> graphs;
     LoadSaveGraphDatasets::LoadPreprocessedTUDortmundGraphData(db, processed_graph_path, graphs);
+    load_stage.Stop();
     if (graphs.graphData.empty()) {
         std::cerr << "No graphs loaded for db='" << db << "' from '" << processed_graph_path << "'\n";
         return 1;
@@ -90,10 +300,13 @@ inline int analyze_mappings(const std::string& db,
         std::cerr << "Mappings file not found: " << mappings_path_a << "\n";
         return 2;
     }
+    ScopedPerfStage mappings_stage("load_mappings");
     BinaryToGEDResult(mappings_path_a, graphs, results_a);
+    mappings_stage.Stop();
     std::cout << "Loaded " << results_a.size() << " mappings from " << mappings_path_a << "\n";
 
     // Count the invalid mappings
+    ScopedPerfStage statistics_stage("statistics");
     auto invalids = CheckResultsValidity(results_a);
     if (!invalids.empty()) {
         std::cerr << "Warning: Found invalid mappings for the following result ids (these will be skipped):\n";
@@ -105,7 +318,7 @@ inline int analyze_mappings(const std::string& db,
     }
 
     // Build map from pair->distance
-    std::unordered_map<std::pair<INDEX, INDEX>, double, PairHash> map_a;
+    DistanceMap map_a;
     for (const auto& r : results_a) {
         map_a[{r.graph_ids.first, r.graph_ids.second}] = r.distance;
     }
@@ -116,6 +329,10 @@ inline int analyze_mappings(const std::string& db,
         return v;
     }());
     print_stats(method + " (" + db + ")", stats_a);
+    // missing or stale metadata (e.g. mappings written by an older version): store it for the next summary query
+    WriteMappingSummary(mappings_dir_a, db, SummarizeMappings(results_a));
+    check_distances_with_features(db, processed_graph_path, map_a);
+    statistics_stage.Stop();
 
     // If compare_method provided, load and compare
     if (!compare_method.empty()) {
@@ -124,58 +341,14 @@ inline int analyze_mappings(const std::string& db,
             return 3;
         }
         std::vector<GEDEvaluation<UDataGraph>> results_b;
+        ScopedPerfStage compare_stage("compare_mappings");
         BinaryToGEDResult(mappings_path_b, graphs, results_b);
         std::cout << "Loaded " << results_b.size() << " mappings from " << mappings_path_b << "\n";
-        std::unordered_map<std::pair<INDEX, INDEX>, double, PairHash> map_b;
+        DistanceMap map_b;
         for (const auto& r : results_b) {
             map_b[{r.graph_ids.first, r.graph_ids.second}] = r.distance;
         }
-
-        // gather pairs present in both
-        std::vector<double> paired_a;
-        std::vector<double> paired_b;
-        paired_a.reserve(std::min(map_a.size(), map_b.size()));
-        paired_b.reserve(std::min(map_a.size(), map_b.size()));
-        for (const auto &kv : map_a) {
-            auto key = kv.first;
-            auto it = map_b.find(key);
-            if (it != map_b.end()) {
-                paired_a.push_back(kv.second);
-                paired_b.push_back(it->second);
-            }
-        }
-        std::cout << "Found " << paired_a.size() << " common graph pairs between methods.\n";
-        if (paired_a.empty()) {
-            std::cerr << "No overlapping pairs to compare.\n";
-            return 4;
-        }
-
-        // compute diff statistics
-        std::vector<double> diffs; diffs.reserve(paired_a.size());
-        for (size_t i = 0; i < paired_a.size(); ++i) diffs.push_back(paired_a[i] - paired_b[i]);
-        Stats stats_b = compute_stats(paired_b);
-        Stats stats_diff = compute_stats(diffs);
-        print_stats(compare_method + " (" + db + ")", stats_b);
-        print_stats(std::string("Difference (") + method + " - " + compare_method + ")", stats_diff);
-
-        // optional CSV output
-        if (!csv_out.empty()) {
-            std::ofstream ofs(csv_out);
-            if (!ofs.is_open()) {
-                std::cerr << "Failed to open CSV output: " << csv_out << "\n";
-            } else {
-                ofs << "id1,id2," << method << "," << compare_method << ",diff\n";
-                for (const auto &kv : map_a) {
-                    auto key = kv.first;
-                    auto it = map_b.find(key);
-                    if (it != map_b.end()) {
-                        ofs << key.first << "," << key.second << "," << kv.second << "," << it->second << "," << (kv.second - it->second) << "\n";
-                    }
-                }
-                ofs.close();
-                std::cout << "Wrote comparison CSV to " << csv_out << "\n";
-            }
-        }
+        return compare_distances(db, map_a, map_b, method, compare_method, csv_out);
     }
     return 0;
 }
@@ -0,0 +1,358 @@
+// Native batched BIPARTITE engine for bulk approximate GED on many small graph pairs.
+// Instead of one GEDEnv::run_method per pair, the labels of the dataset are mapped once to dense ids and every node
+// gets the sorted labels of its incident edges (local edge-label histogram). Per pair the node assignment cost matrix
+// is built from them and solved with a shortest augmenting path LSAP solver (Jonker-Volgenant), pairs in parallel with
+// one reusable workspace per thread. The results are GEDEvaluations like the ones of GEDLIB: the node map is the
+// optimal assignment of BIPARTITE's matrix (full incident edge costs) and the upper bound the cost of the edit path it
+// induces. The lower bound is the optimum of BRANCH's matrix (halved incident edge costs), solved as a second LSAP.
+
+#ifndef GEDPATHS_BATCHED_BIPARTITE_H
+#define GEDPATHS_BATCHED_BIPARTITE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <omp.h>
+#include <libGraph.h>
+#include <src/env/ged_env.hpp>
+#include "src/graph_store.h"
+
+// Edit costs of the batched engine, the defaults are the ones of GEDLIB's CONSTANT costs
+struct BipartiteEditCosts {
+    double node_ins = 4;
+    double node_del = 4;
+    double node_rel = 2;
+    double edge_ins = 1;
+    double edge_del = 1;
+    double edge_rel = 1;
+
+    // Only the CONSTANT costs have a native implementation, returns false for all others
+    static bool For(ged::Options::EditCosts edit_cost, BipartiteEditCosts& costs) {
+        if (edit_cost != ged::Options::EditCosts::CONSTANT) {
+            return false;
+        }
+        costs = BipartiteEditCosts{};
+        return true;
+    }
+};
+
+// Dense square linear sum assignment: row_to_col[i] is the column of row i. Shortest augmenting paths with
+// dual potentials (Jonker-Volgenant), O(n^3), all buffers are kept between calls.
+class LSAPSolver {
+public:
+    double Solve(const std::vector<double>& cost, int n, std::vector<int>& row_to_col);
+private:
+    std::vector<double> _u;
+    std::vector<double> _v;
+    std::vector<double> _min_slack;
+    std::vector<int> _col_to_row;
+    std::vector<int> _way;
+    std::vector<char> _used;
+    std::vector<int> _free_rows;
+};
+
+inline double LSAPSolver::Solve(const std::vector<double> &cost, int n, std::vector<int> &row_to_col) {
+    constexpr double infinity = std::numeric_limits<double>::max();
+    // index 0 is the virtual row/column the augmenting paths start from, real rows and columns are 1..n
+    _u.assign(n + 1, 0);
+    _v.assign(n + 1, 0);
+    _col_to_row.assign(n + 1, 0);
+    _way.assign(n + 1, 0);
+    // column reduction as in Jonker-Volgenant: every column gets its minimum as potential and is assigned to the
+    // minimizing row if that row is still free, only the remaining rows need augmenting paths
+    std::vector<char>& row_assigned = _used;
+    row_assigned.assign(n + 1, 0);
+    for (int col = 1; col <= n; ++col) {
+        int best_row = 1;
+        for (int row = 2; row <= n; ++row) {
+            if (cost[static_cast<size_t>(row - 1) * n + col - 1] < cost[static_cast<size_t>(best_row - 1) * n + col - 1]) {
+                best_row = row;
+            }
+        }
+        _v[col] = cost[static_cast<size_t>(best_row - 1) * n + col - 1];
+        if (!row_assigned[best_row]) {
+            row_assigned[best_row] = 1;
+            _col_to_row[col] = best_row;
+        }
+    }
+    _free_rows.clear();
+    for (int row = 1; row <= n; ++row) {
+        if (!row_assigned[row]) {
+            _free_rows.push_back(row);
+        }
+    }
+    for (const int row : _free_rows) {
+        _col_to_row[0] = row;
+        int col0 = 0;
+        _min_slack.assign(n + 1, infinity);
+        _used.assign(n + 1, 0);
+        do {
+            _used[col0] = 1;
+            const int row0 = _col_to_row[col0];
+            const double* cost_row = cost.data() + static_cast<size_t>(row0 - 1) * n;
+            double delta = infinity;
+            int col1 = 0;
+            for (int col = 1; col <= n; ++col) {
+                if (!_used[col]) {
+                    const double slack = cost_row[col - 1] - _u[row0] - _v[col];
+                    if (slack < _min_slack[col]) {
+                        _min_slack[col] = slack;
+                        _way[col] = col0;
+                    }
+                    if (_min_slack[col] < delta) {
+                        delta = _min_slack[col];
+                        col1 = col;
+                    }
+                }
+            }
+            for (int col = 0; col <= n; ++col) {
+                if (_used[col]) {
+                    _u[_col_to_row[col]] += delta;
+                    _v[col] -= delta;
+                }
+                else {
+                    _min_slack[col] -= delta;
+                }
+            }
+            col0 = col1;
+        } while (_col_to_row[col0] != 0);
+        // augment along the alternating path
+        do {
+            const int col1 = _way[col0];
+            _col_to_row[col0] = _col_to_row[col1];
+            col0 = col1;
+        } while (col0 != 0);
+    }
+    row_to_col.assign(n, -1);
+    double total = 0;
+    for (int col = 1; col <= n; ++col) {
+        row_to_col[_col_to_row[col] - 1] = col - 1;
+        total += cost[static_cast<size_t>(_col_to_row[col] - 1) * n + col - 1];
+    }
+    return total;
+}
+
+class BatchedBipartite {
+public:
+    BatchedBipartite(const SharedGraphStore& store, const BipartiteEditCosts& costs);
+    // Per-thread buffers, reused for all pairs of a thread
+    struct Workspace {
+        LSAPSolver solver;
+        std::vector<double> cost;
+        std::vector<int> assignment;
+        std::vector<int32_t> target_edges;
+    };
+    // Mapping of one pair without the graphs (GEDEvaluation::graphs stays empty)
+    [[nodiscard]] GEDEvaluation<UDataGraph> Compute(INDEX source_id, INDEX target_id, Workspace& workspace) const;
+    // The first max_pairs pairs in parallel, the results are in the order of the pairs and carry their graphs from
+    // graphs (the dataset the store was built from), as the results of ComputeGEDResult do
+    [[nodiscard]] std::vector<GEDEvaluation<UDataGraph>> Compute(const GraphData<UDataGraph>& graphs, const std::vector<std::pair<INDEX, INDEX>>& graph_pairs, size_t max_pairs, int num_threads) const;
+
+private:
+    [[nodiscard]] INDEX nodes(INDEX graph_id) const { return _node_offsets[graph_id + 1] - _node_offsets[graph_id]; }
+    // (n + m) x (n + m) assignment matrix of the pair, the incident edge costs are multiplied by edge_factor
+    // (1 for BIPARTITE's upper bound matrix, 0.5 for BRANCH's lower bound matrix)
+    void BuildCostMatrix(INDEX source_id, INDEX target_id, double edge_factor, std::vector<double>& cost) const;
+    // Cost of the optimal assignment of the incident edges of two (global) nodes
+    [[nodiscard]] double IncidentEdgeCost(size_t source_node, size_t target_node) const;
+
+    BipartiteEditCosts _costs;
+    // global node ids: graph i has the nodes _node_offsets[i].._node_offsets[i+1]
+    std::vector<size_t> _node_offsets{0};
+    std::vector<uint32_t> _node_labels;
+    // per global node the sorted dense labels of its incident edges
+    std::vector<size_t> _incident_offsets{0};
+    std::vector<uint32_t> _incident_labels;
+    // per graph its edges with dense labels
+    std::vector<size_t> _edge_offsets{0};
+    std::vector<std::pair<INDEX, INDEX>> _edges;
+    std::vector<uint32_t> _edge_labels;
+};
+
+inline BatchedBipartite::BatchedBipartite(const SharedGraphStore &store, const BipartiteEditCosts &costs) : _costs(costs) {
+    std::unordered_map<GraphStoreLabel, uint32_t> node_label_ids;
+    std::unordered_map<GraphStoreLabel, uint32_t> edge_label_ids;
+    auto dense_id = [](std::unordered_map<GraphStoreLabel, uint32_t>& ids, GraphStoreLabel label) {
+        return ids.try_emplace(label, static_cast<uint32_t>(ids.size())).first->second;
+    };
+    for (INDEX graph_id = 0; graph_id < store.size(); ++graph_id) {
+        for (const auto label : store.node_labels(graph_id)) {
+            _node_labels.push_back(dense_id(node_label_ids, label));
+        }
+        _node_offsets.push_back(_node_labels.size());
+        std::vector<std::vector<uint32_t>> incident(store.nodes(graph_id));
+        for (const auto& edge : store.edge_list(graph_id)) {
+            const uint32_t label = dense_id(edge_label_ids, edge.label);
+            _edges.emplace_back(edge.source, edge.target);
+            _edge_labels.push_back(label);
+            incident[edge.source].push_back(label);
+            incident[edge.target].push_back(label);
+        }
+        _edge_offsets.push_back(_edges.size());
+        for (auto& labels : incident) {
+            std::ranges::sort(labels);
+            _incident_labels.insert(_incident_labels.end(), labels.begin(), labels.end());
+            _incident_offsets.push_back(_incident_labels.size());
+        }
+    }
+}
+
+inline double BatchedBipartite::IncidentEdgeCost(size_t source_node, size_t target_node) const {
+    const uint32_t* a = _incident_labels.data() + _incident_offsets[source_node];
+    const uint32_t* a_end = _incident_labels.data() + _incident_offsets[source_node + 1];
+    const uint32_t* b = _incident_labels.data() + _incident_offsets[target_node];
+    const uint32_t* b_end = _incident_labels.data() + _incident_offsets[target_node + 1];
+    const size_t degree_a = a_end - a;
+    const size_t degree_b = b_end - b;
+    size_t overlap = 0;
+    while (a != a_end && b != b_end) {
+        if (*a < *b) {
+            ++a;
+        }
+        else if (*b < *a) {
+            ++b;
+        }
+        else {
+            ++overlap;
+            ++a;
+            ++b;
+        }
+    }
+    // optimal assignment of the incident edges: equal labels are free, the rest is relabeled, deleted or inserted
+    const double relabel = std::min(_costs.edge_rel, _costs.edge_del + _costs.edge_ins);
+    const size_t common = std::min(degree_a, degree_b);
+    return relabel * static_cast<double>(common - overlap)
+           + _costs.edge_del * static_cast<double>(degree_a - common)
+           + _costs.edge_ins * static_cast<double>(degree_b - common);
+}
+
+inline void BatchedBipartite::BuildCostMatrix(INDEX source_id, INDEX target_id, double edge_factor, std::vector<double> &cost) const {
+    const INDEX n = nodes(source_id);
+    const INDEX m = nodes(target_id);
+    const size_t source_offset = _node_offsets[source_id];
+    const size_t target_offset = _node_offsets[target_id];
+    const size_t size = n + m;
+    // substitutions | deletions (diagonal) / insertions (diagonal) | dummy-dummy (free)
+    constexpr double forbidden = 1e12;
+    cost.assign(size * size, forbidden);
+    for (INDEX i = 0; i < n; ++i) {
+        const size_t source_node = source_offset + i;
+        const double source_degree = static_cast<double>(_incident_offsets[source_node + 1] - _incident_offsets[source_node]);
+        double* row = cost.data() + static_cast<size_t>(i) * size;
+        for (INDEX k = 0; k < m; ++k) {
+            const size_t target_node = target_offset + k;
+            row[k] = (_node_labels[source_node] != _node_labels[target_node] ? _costs.node_rel : 0.0)
+                     + edge_factor * IncidentEdgeCost(source_node, target_node);
+        }
+        row[m + i] = _costs.node_del + edge_factor * _costs.edge_del * source_degree;
+    }
+    for (INDEX k = 0; k < m; ++k) {
+        const size_t target_node = target_offset + k;
+        const double target_degree = static_cast<double>(_incident_offsets[target_node + 1] - _incident_offsets[target_node]);
+        double* row = cost.data() + static_cast<size_t>(n + k) * size;
+        row[k] = _costs.node_ins + edge_factor * _costs.edge_ins * target_degree;
+        std::fill(row + m, row + m + n, 0.0);
+    }
+}
+
+inline GEDEvaluation<UDataGraph> BatchedBipartite::Compute(INDEX source_id, INDEX target_id, Workspace &workspace) const {
+    const INDEX n = nodes(source_id);
+    const INDEX m = nodes(target_id);
+    const size_t source_offset = _node_offsets[source_id];
+    const size_t target_offset = _node_offsets[target_id];
+    const int size = static_cast<int>(n + m);
+    // lower bound first, the assignment of the upper bound matrix is the node map
+    double lower_bound = 0.0;
+    if (size > 0) {
+        BuildCostMatrix(source_id, target_id, 0.5, workspace.cost);
+        lower_bound = workspace.solver.Solve(workspace.cost, size, workspace.assignment);
+        BuildCostMatrix(source_id, target_id, 1.0, workspace.cost);
+        workspace.solver.Solve(workspace.cost, size, workspace.assignment);
+    }
+
+    GEDEvaluation<UDataGraph> result;
+    result.graph_ids = {source_id, target_id};
+    result.node_mapping.first.assign(n, ged::GEDGraph::dummy_node());
+    result.node_mapping.second.assign(m, ged::GEDGraph::dummy_node());
+    double upper_bound = 0;
+    for (INDEX i = 0; i < n; ++i) {
+        if (const auto k = static_cast<INDEX>(workspace.assignment[i]); k < m) {
+            result.node_mapping.first[i] = k;
+            result.node_mapping.second[k] = i;
+            upper_bound += _node_labels[source_offset + i] != _node_labels[target_offset + k] ? _costs.node_rel : 0.0;
+        }
+        else {
+            upper_bound += _costs.node_del;
+        }
+    }
+    for (INDEX k = 0; k < m; ++k) {
+        if (result.node_mapping.second[k] == ged::GEDGraph::dummy_node()) {
+            upper_bound += _costs.node_ins;
+        }
+    }
+    // edges of the induced edit path, the target edges are looked up in a dense label matrix (-1 = no edge)
+    auto& target_edges = workspace.target_edges;
+    target_edges.assign(static_cast<size_t>(m) * m, -1);
+    for (size_t e = _edge_offsets[target_id]; e < _edge_offsets[target_id + 1]; ++e) {
+        const auto [a, b] = _edges[e];
+        target_edges[static_cast<size_t>(a) * m + b] = static_cast<int32_t>(_edge_labels[e]);
+        target_edges[static_cast<size_t>(b) * m + a] = static_cast<int32_t>(_edge_labels[e]);
+    }
+    size_t matched_edges = 0;
+    for (size_t e = _edge_offsets[source_id]; e < _edge_offsets[source_id + 1]; ++e) {
+        const auto [a, b] = _edges[e];
+        const INDEX image_a = result.node_mapping.first[a];
+        const INDEX image_b = result.node_mapping.first[b];
+        int32_t target_label = -1;
+        if (image_a != ged::GEDGraph::dummy_node() && image_b != ged::GEDGraph::dummy_node()) {
+            target_label = target_edges[static_cast<size_t>(image_a) * m + image_b];
+        }
+        if (target_label < 0) {
+            upper_bound += _costs.edge_del;
+        }
+        else {
+            ++matched_edges;
+            upper_bound += static_cast<uint32_t>(target_label) != _edge_labels[e] ? _costs.edge_rel : 0.0;
+        }
+    }
+    upper_bound += _costs.edge_ins * static_cast<double>(_edge_offsets[target_id + 1] - _edge_offsets[target_id] - matched_edges);
+
+    result.lower_bound = lower_bound;
+    result.upper_bound = upper_bound;
+    result.distance = upper_bound;
+    return result;
+}
+
+inline std::vector<GEDEvaluation<UDataGraph>> BatchedBipartite::Compute(const GraphData<UDataGraph> &graphs, const std::vector<std::pair<INDEX, INDEX>> &graph_pairs, size_t max_pairs, int num_threads) const {
+    const size_t num_pairs = std::min(max_pairs, graph_pairs.size());
+    // process the pairs grouped by source graph so its nodes stay in cache, results go back to the pair order
+    std::vector<size_t> order(num_pairs);
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::sort(order, [&graph_pairs](size_t a, size_t b) { return graph_pairs[a] < graph_pairs[b]; });
+    std::vector<GEDEvaluation<UDataGraph>> results(num_pairs);
+    std::atomic<size_t> finished_pairs = 0;
+    const size_t print_interval = std::max<size_t>(1, num_pairs / 100);
+#pragma omp parallel num_threads(std::max(1, num_threads))
+    {
+        Workspace workspace;
+#pragma omp for schedule(dynamic, 256)
+        for (size_t i = 0; i < num_pairs; ++i) {
+            const auto [source_id, target_id] = graph_pairs[order[i]];
+            results[order[i]] = Compute(source_id, target_id, workspace);
+            results[order[i]].graphs = {graphs.graphData[source_id], graphs.graphData[target_id]};
+            if (const size_t finished = ++finished_pairs; finished % print_interval == 0 || finished == num_pairs) {
+#pragma omp critical
+                std::cout << "Computed " << finished << " of " << num_pairs << " GED mappings" << std::endl;
+            }
+        }
+    }
+    return results;
+}
+
+#endif //GEDPATHS_BATCHED_BIPARTITE_H
@@ -0,0 +1,272 @@
+// Offset index over .bgf graph files: single graphs are read by id without loading the whole file. Has no GEDLIB
+// dependency, so the tools that only read graph and edit path files (AnalyzePaths, AnalyzeMappings, CreatePaths,
+// ExportPathLayouts) can use it without pulling in the GED environment.
+
+#ifndef GEDPATHS_BGF_INDEX_H
+#define GEDPATHS_BGF_INDEX_H
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <libGraph.h>
+#include "src/graph_store_types.h"
+
+// compatibility format version of the .bgf files written by libGraph, the only layout the index understands
+constexpr int32_t BGF_FORMAT_VERSION = 0;
+
+// One graph as read from a .bgf file (primary labels only)
+struct StoredGraph {
+    std::string name;
+    std::vector<GraphStoreLabel> node_labels;
+    std::vector<GraphStoreEdge> edges;
+    [[nodiscard]] INDEX nodes() const { return node_labels.size(); }
+    [[nodiscard]] size_t MemoryBytes() const { return sizeof(StoredGraph) + name.capacity() + node_labels.capacity() * sizeof(GraphStoreLabel) + edges.capacity() * sizeof(GraphStoreEdge); }
+};
+
+// Offset index over a .bgf file. The layout is: format version, number of graphs, all graph headers
+// (name, type, node count, node feature names, edge count, edge feature names) and then the data of every graph
+// (node features as doubles, edges as (size_t, size_t, edge features)). The data offsets follow from the headers,
+// so building the index only reads the header block. Files of other format versions are rejected.
+class BGFIndex {
+public:
+    struct Entry {
+        std::string name;
+        INDEX nodes = 0;
+        INDEX edges = 0;
+        uint32_t node_features = 0;
+        uint32_t edge_features = 0;
+        // column of the feature called "label" (or -1)
+        int node_label_column = -1;
+        int edge_label_column = -1;
+        uint64_t data_offset = 0;
+    };
+
+    BGFIndex() = default;
+    ~BGFIndex();
+    BGFIndex(const BGFIndex&) = delete;
+    BGFIndex& operator=(const BGFIndex&) = delete;
+
+    // returns nullptr (and prints the reason) if the file cannot be indexed. With require_labels every graph needs a
+    // node feature called "label" (and one for the edges if they have features), otherwise the labels could not be read.
+    static std::unique_ptr<BGFIndex> Open(const std::string& path, bool require_labels = true);
+    [[nodiscard]] INDEX size() const { return _entries.size(); }
+    [[nodiscard]] const Entry& entry(INDEX graph_id) const { return _entries[graph_id]; }
+    [[nodiscard]] const std::string& path() const { return _path; }
+    // Read one graph from disk (thread-safe, uses pread), returns false (and prints the reason) if the read fails
+    [[nodiscard]] bool ReadGraph(INDEX graph_id, StoredGraph& graph) const;
+    // Read one graph with all its node and edge feature values as libGraph graph (thread-safe)
+    [[nodiscard]] bool ReadGraph(INDEX graph_id, UDataGraph& graph) const;
+private:
+    static int LabelColumn(const std::vector<std::string>& feature_names);
+    // the node feature and edge data block of the graph
+    [[nodiscard]] bool ReadData(INDEX graph_id, std::vector<char>& buffer) const;
+    std::string _path;
+    int _fd = -1;
+    std::vector<Entry> _entries;
+};
+
+inline BGFIndex::~BGFIndex() {
+    if (_fd >= 0) {
+        close(_fd);
+    }
+}
+
+inline int BGFIndex::LabelColumn(const std::vector<std::string> &feature_names) {
+    for (size_t i = 0; i < feature_names.size(); ++i) {
+        std::string name = feature_names[i];
+        std::ranges::transform(name, name.begin(), [](unsigned char c) { return std::tolower(c); });
+        if (name == "label") {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+inline std::unique_ptr<BGFIndex> BGFIndex::Open(const std::string &path, bool require_labels) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "Could not open graph file " << path << std::endl;
+        return nullptr;
+    }
+    auto read_int = [&in]() { int32_t value = 0; in.read(reinterpret_cast<char*>(&value), sizeof(value)); return value; };
+    auto read_uint = [&in]() { uint32_t value = 0; in.read(reinterpret_cast<char*>(&value), sizeof(value)); return value; };
+    auto read_size = [&in]() { uint64_t value = 0; in.read(reinterpret_cast<char*>(&value), sizeof(value)); return value; };
+    auto read_string = [&]() {
+        std::string value(read_uint(), '\0');
+        in.read(value.data(), static_cast<std::streamsize>(value.size()));
+        return value;
+    };
+
+    auto index = std::make_unique<BGFIndex>();
+    index->_path = path;
+    const int32_t version = read_int();
+    const int32_t graph_number = read_int();
+    if (!in || graph_number < 0) {
+        std::cerr << "Invalid graph file header in " << path << std::endl;
+        return nullptr;
+    }
+    if (version != BGF_FORMAT_VERSION) {
+        std::cerr << "Unsupported graph file format version " << version << " in " << path << " (expected " << BGF_FORMAT_VERSION << ")" << std::endl;
+        return nullptr;
+    }
+    index->_entries.resize(graph_number);
+    for (auto& entry : index->_entries) {
+        entry.name = read_string();
+        [[maybe_unused]] const int32_t graph_type = read_int();
+        entry.nodes = read_size();
+        entry.node_features = read_uint();
+        std::vector<std::string> node_feature_names(entry.node_features);
+        for (auto& name : node_feature_names) {
+            name = read_string();
+        }
+        entry.edges = read_size();
+        entry.edge_features = read_uint();
+        std::vector<std::string> edge_feature_names(entry.edge_features);
+        for (auto& name : edge_feature_names) {
+            name = read_string();
+        }
+        entry.node_label_column = LabelColumn(node_feature_names);
+        entry.edge_label_column = LabelColumn(edge_feature_names);
+        if (!in) {
+            std::cerr << "Truncated graph headers in " << path << std::endl;
+            return nullptr;
+        }
+        // unlabeled edges (no edge features) are fine, features without a label column are not
+        if (require_labels && entry.nodes > 0 && (entry.node_label_column < 0 || (entry.edge_features > 0 && entry.edge_label_column < 0))) {
+            std::cerr << "Graph " << entry.name << " in " << path << " has no " << (entry.node_label_column < 0 ? "node" : "edge") << " feature called \"label\"" << std::endl;
+            return nullptr;
+        }
+    }
+    uint64_t offset = in.tellg();
+    for (auto& entry : index->_entries) {
+        entry.data_offset = offset;
+        offset += entry.nodes * entry.node_features * sizeof(double)
+                + entry.edges * (2 * sizeof(uint64_t) + entry.edge_features * sizeof(double));
+    }
+    index->_fd = open(path.c_str(), O_RDONLY);
+    if (index->_fd < 0) {
+        std::cerr << "Could not open graph file " << path << std::endl;
+        return nullptr;
+    }
+    return index;
+}
+
+inline bool BGFIndex::ReadData(INDEX graph_id, std::vector<char>& buffer) const {
+    const Entry& entry = _entries[graph_id];
+    const size_t edge_record = 2 * sizeof(uint64_t) + entry.edge_features * sizeof(double);
+    buffer.resize(entry.nodes * entry.node_features * sizeof(double) + entry.edges * edge_record);
+    size_t read_bytes = 0;
+    while (read_bytes < buffer.size()) {
+        const ssize_t result = pread(_fd, buffer.data() + read_bytes, buffer.size() - read_bytes, static_cast<off_t>(entry.data_offset + read_bytes));
+        if (result <= 0) {
+            std::cerr << "Could not read graph " << graph_id << " from " << _path << std::endl;
+            return false;
+        }
+        read_bytes += result;
+    }
+    return true;
+}
+
+inline bool BGFIndex::ReadGraph(INDEX graph_id, StoredGraph& graph) const {
+    const Entry& entry = _entries[graph_id];
+    const size_t edge_record = 2 * sizeof(uint64_t) + entry.edge_features * sizeof(double);
+    std::vector<char> buffer;
+    if (!ReadData(graph_id, buffer)) {
+        return false;
+    }
+
+    graph.name = entry.name;
+    graph.node_labels.assign(entry.nodes, 0);
+    const char* data = buffer.data();
+    if (entry.node_label_column >= 0) {
+        for (INDEX node = 0; node < entry.nodes; ++node) {
+            double label;
+            std::memcpy(&label, data + (node * entry.node_features + entry.node_label_column) * sizeof(double), sizeof(double));
+            graph.node_labels[node] = static_cast<GraphStoreLabel>(label);
+        }
+    }
+    data += entry.nodes * entry.node_features * sizeof(double);
+    graph.edges.clear();
+    graph.edges.reserve(entry.edges);
+    for (INDEX edge = 0; edge < entry.edges; ++edge, data += edge_record) {
+        uint64_t source, target;
+        std::memcpy(&source, data, sizeof(uint64_t));
+        std::memcpy(&target, data + sizeof(uint64_t), sizeof(uint64_t));
+        double label = 0;
+        if (entry.edge_label_column >= 0) {
+            std::memcpy(&label, data + 2 * sizeof(uint64_t) + entry.edge_label_column * sizeof(double), sizeof(double));
+        }
+        graph.edges.push_back({std::min(source, target), std::max(source, target), static_cast<GraphStoreLabel>(label)});
+    }
+    return true;
+}
+
+inline bool BGFIndex::ReadGraph(INDEX graph_id, UDataGraph& graph) const {
+    const Entry& entry = _entries[graph_id];
+    const size_t edge_record = 2 * sizeof(uint64_t) + entry.edge_features * sizeof(double);
+    std::vector<char> buffer;
+    if (!ReadData(graph_id, buffer)) {
+        return false;
+    }
+    auto read_features = [](const char* data, uint32_t count) {
+        std::vector<double> features(count);
+        std::memcpy(features.data(), data, count * sizeof(double));
+        return features;
+    };
+    graph = UDataGraph();
+    graph.SetName(entry.name);
+    std::vector<std::vector<double>> node_features(entry.nodes);
+    for (INDEX node = 0; node < entry.nodes; ++node) {
+        node_features[node] = read_features(buffer.data() + node * entry.node_features * sizeof(double), entry.node_features);
+    }
+    graph.AddNodes(entry.nodes, node_features);
+    const char* data = buffer.data() + entry.nodes * entry.node_features * sizeof(double);
+    for (INDEX edge = 0; edge < entry.edges; ++edge, data += edge_record) {
+        uint64_t source, target;
+        std::memcpy(&source, data, sizeof(uint64_t));
+        std::memcpy(&target, data + sizeof(uint64_t), sizeof(uint64_t));
+        graph.AddEdge(source, target, read_features(data + 2 * sizeof(uint64_t), entry.edge_features), false);
+    }
+    return true;
+}
+
+// GraphData with one slot per graph of the .bgf file in which only the given graphs are read, all other slots stay
+// empty graphs so that the positions are the dataset ids. For the consumers of mappings (CreatePaths, AnalyzeMappings
+// with -lazy), which only touch the graphs of the mappings they process. Returns false if a graph cannot be read.
+inline bool LoadGraphsById(const BGFIndex& index, const std::vector<INDEX>& graph_ids, GraphData<UDataGraph>& graphs) {
+    if (graphs.graphData.size() != index.size()) {
+        graphs.graphData.clear();
+        graphs.graphData.resize(index.size());
+    }
+    bool read_failed = false;
+#pragma omp parallel for schedule(dynamic) reduction(||:read_failed)
+    for (size_t i = 0; i < graph_ids.size(); ++i) {
+        if (graph_ids[i] >= index.size()) {
+            std::cerr << "Graph " << graph_ids[i] << " is not in " << index.path() << std::endl;
+            read_failed = true;
+        }
+        else if (!index.ReadGraph(graph_ids[i], graphs.graphData[graph_ids[i]])) {
+            read_failed = true;
+        }
+    }
+    return !read_failed;
+}
+
+// Empty the slots of the given graphs again (the next batch of a -lazy consumer reuses the GraphData)
+inline void UnloadGraphsById(const std::vector<INDEX>& graph_ids, GraphData<UDataGraph>& graphs) {
+    for (const INDEX graph_id : graph_ids) {
+        if (graph_id < graphs.graphData.size()) {
+            graphs.graphData[graph_id] = UDataGraph();
+        }
+    }
+}
+
+#endif //GEDPATHS_BGF_INDEX_H
@@ -9,10 +9,22 @@
 
 #ifndef GEDPATHS_CREATE_EDIT_MAPPINGS_H
 #define GEDPATHS_CREATE_EDIT_MAPPINGS_H
+#include <optional>
 #include <utility>
 #include <vector>
 #include <libGraph.h>
 #include <src/env/ged_env.hpp>
+#include <omp.h>
+#include "src/graph_store.h"
+#include "src/numa.h"
+#include "src/shm_store.h"
+#include "src/lazy_graph_store.h"
+#include "src/pair_selection.h"
+#include "src/perf_counters.h"
+#include "src/mapping_store.h"
+#include "src/solver_slots.h"
+#include "src/graph_features.h"
+#include "src/batched_bipartite.h"
 
 int create_edit_mappings(const std::string& db,
                             const std::string& output_path,
@@ -22,26 +34,35 @@ int create_edit_mappings(const std::string& db,
                           ged::Options::GEDMethod ged_method,
                           const std::string& method_options = "",
                           const std::string& graph_ids_path = "",
+                          const std::string& pairs_file = "",
                           int num_pairs = -1,
                           int num_threads = 1,
                           int seed = 42,
                           int single_source = -1,
-                          int single_target = -1);
+                          int single_target = -1,
+                          bool numa = false,
+                          const std::string& shm_name = "",
+                          const std::string& shm_publish = "",
+                          size_t lazy_cache_graphs = 0,
+                          bool batched_bipartite = false);
 
-GEDEvaluation<UDataGraph> create_edit_mappings_single(INDEX source_id, INDEX target_id, GraphData<UDataGraph>& graphs, ged::Options::EditCosts edit_cost, ged::Options::GEDMethod ged_method, const std::string& method_options = "", bool print = false);
+GEDEvaluation<UDataGraph> create_edit_mappings_single(INDEX source_id, INDEX target_id, GraphData<UDataGraph>& graphs, const SharedGraphStore& store, ged::Options::EditCosts edit_cost, ged::Options::GEDMethod ged_method, const std::string& method_options = "", bool print = false);
 
 
-inline GEDEvaluation<UDataGraph> create_edit_mappings_single(INDEX source_id, INDEX target_id, GraphData<UDataGraph>& graphs, ged::Options::EditCosts edit_cost, ged::Options::GEDMethod ged_method, const std::string& method_options, bool print) {
+inline GEDEvaluation<UDataGraph> create_edit_mappings_single(INDEX source_id, INDEX target_id, GraphData<UDataGraph>& graphs, const SharedGraphStore& store, ged::Options::EditCosts edit_cost, ged::Options::GEDMethod ged_method, const std::string& method_options, bool print) {
     if (source_id >= graphs.graphData.size() || target_id >= graphs.graphData.size()) {
         std::cerr << "Single source/target IDs out of range: " << source_id << ", " << target_id << std::endl;
         exit(1);
     }
     std::pair<INDEX, INDEX> pair = std::minmax(source_id, target_id);
     std::vector<std::pair<INDEX, INDEX>> single_pair{pair};
+    // the environment only gets the two graphs of the pair, all others stay empty placeholders of the shared store
     auto ged_env = ged::GEDEnv<ged::LabelID, ged::LabelID, ged::LabelID>();
-    InitializeGEDEnvironment(ged_env, graphs, edit_cost, ged_method, method_options);
-    std::vector<GEDEvaluation<UDataGraph>> results;
-    ged_env.run_method(pair.first, pair.second);
+    InitializeGEDEnvironmentFromStore(ged_env, store, {pair.first, pair.second}, edit_cost, ged_method, method_options);
+    {
+        SolverSlotGuard slot(ged_method, method_options);
+        ged_env.run_method(pair.first, pair.second);
+    }
     GEDEvaluation<UDataGraph> result = ComputeGEDResult(ged_env, graphs, pair.first, pair.second);
     if (print) {
         // Print result for debugging
@@ -65,11 +86,102 @@ inline GEDEvaluation<UDataGraph> create_edit_mappings_single(INDEX source_id, IN
 }
 
 
+inline void print_mapping(INDEX source_id, INDEX target_id, double distance, double lower_bound, double upper_bound,
+                          std::span<const INDEX> source_to_target, std::span<const INDEX> target_to_source) {
+    std::cout << "Computed mapping for pair (" << source_id << ", " << target_id << ")" << std::endl;
+    std::cout << "Distance: " << distance << std::endl;
+    std::cout << "Lower Bound: " << lower_bound << std::endl;
+    std::cout << "Upper Bound: " << upper_bound << std::endl;
+    std::cout << "Node Mapping (source -> target):" << std::endl;
+    for (INDEX i = 0; i < source_to_target.size(); ++i) {
+        std::cout << "  " << i << " -> " << source_to_target[i] << std::endl;
+    }
+    std::cout << "  Target to Source:" << std::endl;
+    for (INDEX i = 0; i < target_to_source.size(); ++i) {
+        std::cout << "  " << i << " -> " << target_to_source[i] << std::endl;
+    }
+}
+
+// Tmp file of the mappings with the given name, from where the next merge (MergeGEDResults, get_existing_mappings)
+// picks the mappings up
+inline std::filesystem::path tmp_mapping_file(const std::string& output_path, const std::string& db, const std::string& name) {
+    return output_path + db + "/tmp/" + db + "_ged_mapping_" + name + ".bin";
+}
+
+// Write mappings as one file into the tmp folder of the mappings. The file is written into a private directory first
+// and then renamed, so a concurrent merge never sees a partially written file.
+inline bool write_tmp_mappings(const std::string& output_path, const std::string& db, const std::string& name, const std::vector<GEDEvaluation<UDataGraph>>& results) {
+    const std::filesystem::path staging = output_path + db + "/staging_" + name + "/";
+    const std::filesystem::path tmp_file = tmp_mapping_file(output_path, db, name);
+    std::error_code error;
+    std::filesystem::create_directories(staging, error);
+    std::filesystem::create_directories(tmp_file.parent_path(), error);
+    GEDResultToBinary(staging.string(), results);
+    bool written = false;
+    for (const auto& entry : std::filesystem::directory_iterator(staging, error)) {
+        if (entry.is_regular_file()) {
+            std::filesystem::rename(entry.path(), tmp_file, error);
+            written = !error;
+            break;
+        }
+    }
+    std::filesystem::remove_all(staging, error);
+    if (!written) {
+        std::cerr << "Could not write " << results.size() << " mappings to " << tmp_file << std::endl;
+    }
+    return written;
+}
+
+// Write the mapping computed by a worker process as its own file into the tmp folder of the mappings for the coordinator
+inline bool write_worker_mapping(const std::string& output_path, const std::string& db, const GEDEvaluation<UDataGraph>& result) {
+    const std::string name = "worker_" + std::to_string(result.graph_ids.first) + "_" + std::to_string(result.graph_ids.second);
+    if (!write_tmp_mappings(output_path, db, name, std::vector<GEDEvaluation<UDataGraph>>{result})) {
+        return false;
+    }
+    std::cout << "Wrote mapping to " << tmp_mapping_file(output_path, db, name) << std::endl;
+    return true;
+}
+
+// Worker mode for multi-process runs: compute one pair using only the attached shared-memory segment, i.e., without
+// loading the dataset or the mapping file. The result is written to the tmp folder of the mappings for the coordinator.
+// Pairs that are already part of the published mappings are only printed.
+inline int create_edit_mappings_single_shm(const std::string& output_path, const std::string& db, INDEX source_id, INDEX target_id, const ShmGraphStore& shm_store, ged::Options::EditCosts edit_cost, ged::Options::GEDMethod ged_method, const std::string& method_options) {
+    if (source_id >= shm_store.size() || target_id >= shm_store.size()) {
+        std::cerr << "Single source/target IDs out of range: " << source_id << ", " << target_id << std::endl;
+        return 1;
+    }
+    std::pair<INDEX, INDEX> pair = std::minmax(source_id, target_id);
+    if (const ShmMappingRecord* record = shm_store.FindMapping(pair.first, pair.second)) {
+        std::cout << "Mapping already exists in the shared mappings" << std::endl;
+        print_mapping(pair.first, pair.second, record->distance, record->lower_bound, record->upper_bound,
+                      shm_store.forward_map(*record), shm_store.backward_map(*record));
+        return 0;
+    }
+    auto ged_env = ged::GEDEnv<ged::LabelID, ged::LabelID, ged::LabelID>();
+    InitializeGEDEnvironmentFromStore(ged_env, shm_store, {pair.first, pair.second}, edit_cost, ged_method, method_options);
+    {
+        SolverSlotGuard slot(ged_method, method_options);
+        ged_env.run_method(pair.first, pair.second);
+    }
+    // as in the environment only the two graphs of the pair are filled, all others stay empty
+    GraphData<UDataGraph> graphs;
+    graphs.graphData.resize(shm_store.size());
+    graphs.graphData[pair.first] = StoreGraphToUDataGraph(shm_store, pair.first);
+    graphs.graphData[pair.second] = StoreGraphToUDataGraph(shm_store, pair.second);
+    const GEDEvaluation<UDataGraph> result = ComputeGEDResult(ged_env, graphs, pair.first, pair.second);
+    print_mapping(pair.first, pair.second, result.distance, result.lower_bound, result.upper_bound,
+                  result.node_mapping.first, result.node_mapping.second);
+    return write_worker_mapping(output_path, db, result) ? 0 : 1;
+}
+
+// Recompute the invalid mappings of results with the method and single-threaded F1/F2, and with the other one of F1/F2
+// if that does not give a valid mapping. solve_pair(source_id, target_id, method, method_options) computes one pair and
+// returns std::nullopt if it cannot (e.g., the graphs could not be read), which counts as not fixed.
+template <typename SolvePair>
 inline void fixInvalidMappings(std::vector<GEDEvaluation<UDataGraph>>& results,
-                               GraphData<UDataGraph>& graphs,
-                               ged::Options::EditCosts edit_cost,
                                ged::Options::GEDMethod ged_method,
-                               const std::string& method_options) {
+                               const std::string& method_options,
+                               SolvePair solve_pair) {
 
     // manipulate the method options as errors seem to come from parallelization in F2/F1
     std::string modified_method_options = method_options;
@@ -106,17 +218,17 @@ inline void fixInvalidMappings(std::vector<GEDEvaluation<UDataGraph>>& results,
     for (const auto &id : invalid_mappings) {
         auto source_id = results[id].graph_ids.first;
         auto target_id = results[id].graph_ids.second;
-        auto fixed_result = create_edit_mappings_single(source_id, target_id, graphs, edit_cost, ged_method, modified_method_options, true);
-        if (CheckResultsValidity(std::vector<GEDEvaluation<UDataGraph>>{fixed_result}).empty()) {
-            fixed_results.emplace_back(id, fixed_result);
+        auto fixed_result = solve_pair(source_id, target_id, ged_method, modified_method_options);
+        if (fixed_result && CheckResultsValidity(std::vector<GEDEvaluation<UDataGraph>>{*fixed_result}).empty()) {
+            fixed_results.emplace_back(id, std::move(*fixed_result));
             std::cout << "  Fixed mapping for result id " << id << " (Graph IDs: " << source_id << ", " << target_id << ")\n";
         }
         else {
             // if F1 fails try F2 and vice versa
             ged::Options::GEDMethod alternative_method = (ged_method == ged::Options::GEDMethod::F1) ? ged::Options::GEDMethod::F2 : ged::Options::GEDMethod::F1;
-            auto alternative_fixed_result = create_edit_mappings_single(source_id, target_id, graphs, edit_cost, alternative_method, modified_method_options, true);
-            if (CheckResultsValidity(std::vector<GEDEvaluation<UDataGraph>>{alternative_fixed_result}).empty()) {
-                fixed_results.emplace_back(id, alternative_fixed_result);
+            auto alternative_fixed_result = solve_pair(source_id, target_id, alternative_method, modified_method_options);
+            if (alternative_fixed_result && CheckResultsValidity(std::vector<GEDEvaluation<UDataGraph>>{*alternative_fixed_result}).empty()) {
+                fixed_results.emplace_back(id, std::move(*alternative_fixed_result));
                 std::cout << "  Fixed mapping for result id " << id << " (Graph IDs: " << source_id << ", " << target_id << ") using alternative method.\n";
             }
             else {
@@ -135,6 +247,278 @@ inline void fixInvalidMappings(std::vector<GEDEvaluation<UDataGraph>>& results,
     std::cout << "Total fixed mappings: " << fixed_results.size() << " of " << invalid_mappings.size() << "\n";
 }
 
+// Repair with the dataset in memory: every pair is recomputed in an environment built from the shared store
+inline void fixInvalidMappings(std::vector<GEDEvaluation<UDataGraph>>& results,
+                               GraphData<UDataGraph>& graphs,
+                               const SharedGraphStore& store,
+                               ged::Options::EditCosts edit_cost,
+                               ged::Options::GEDMethod ged_method,
+                               const std::string& method_options) {
+    fixInvalidMappings(results, ged_method, method_options, [&](INDEX source_id, INDEX target_id, ged::Options::GEDMethod method, const std::string& options) {
+        return std::optional(create_edit_mappings_single(source_id, target_id, graphs, store, edit_cost, method, options, true));
+    });
+}
+
+// Evaluation of a pair computed in an environment that only holds the two graphs of the pair (environment ids 0 and 1),
+// built by libGraph's ComputeGEDResult from the two graphs and then relabeled with the dataset ids
+inline GEDEvaluation<UDataGraph> pair_environment_result(ged::GEDEnv<ged::LabelID, ged::LabelID, ged::LabelID>& ged_env,
+                                                         const UDataGraph& source, const UDataGraph& target,
+                                                         INDEX source_id, INDEX target_id) {
+    GraphData<UDataGraph> pair_graphs;
+    pair_graphs.graphData = {source, target};
+    GEDEvaluation<UDataGraph> result = ComputeGEDResult(ged_env, pair_graphs, 0, 1);
+    result.graph_ids = {source_id, target_id};
+    return result;
+}
+
+inline GEDEvaluation<UDataGraph> pair_environment_result(ged::GEDEnv<ged::LabelID, ged::LabelID, ged::LabelID>& ged_env,
+                                                         const GraphPairView& pair_view,
+                                                         INDEX source_id, INDEX target_id) {
+    return pair_environment_result(ged_env, StoreGraphToUDataGraph(pair_view, 0), StoreGraphToUDataGraph(pair_view, 1), source_id, target_id);
+}
+
+// Compute the mappings on worker threads. Worker t is pinned to NUMA node t % nodes only for the duration of the
+// region (its previous affinity is restored afterwards). MIP solve times differ by orders of magnitude, hence the pairs
+// are handed out one by one from a shared counter instead of fixed chunks. Every claimed pair gets its own environment
+// with only its two graphs, read from the node-local store replica, so the memory of the environments does not grow
+// with the number of workers. Methods that train on all graphs (InitializesOnAllGraphs) need all graphs in their
+// environment, with them every worker builds one environment over its replica instead.
+// As in the default mode the results are checkpointed into the tmp folder of the mappings (a worker writes its new
+// results whenever it has computed another 1% of the pairs), so an interrupted run resumes from them. Returns the written checkpoint files.
+inline std::vector<std::filesystem::path> ComputeGEDResultsNuma(const std::string& output_path,
+                                                                const std::string& db,
+                                                                GraphData<UDataGraph>& graphs,
+                                                                const NumaTopology& topology,
+                                                                const NumaGraphReplicas& replicas,
+                                                                const std::vector<std::pair<INDEX, INDEX>>& graph_pairs,
+                                                                size_t num_pairs,
+                                                                int num_threads,
+                                                                ged::Options::EditCosts edit_cost,
+                                                                ged::Options::GEDMethod ged_method,
+                                                                const std::string& method_options,
+                                                                std::vector<GEDEvaluation<UDataGraph>>& results) {
+    num_pairs = std::min(num_pairs, graph_pairs.size());
+    if (num_pairs == 0) {
+        return {};
+    }
+    num_threads = static_cast<int>(std::clamp<size_t>(num_threads, 1, num_pairs));
+    const bool all_graphs = InitializesOnAllGraphs(ged_method, method_options);
+    std::vector<std::vector<GEDEvaluation<UDataGraph>>> thread_results(num_threads);
+    std::vector<std::vector<std::filesystem::path>> thread_checkpoints(num_threads);
+    std::atomic<size_t> next_pair = 0;
+    std::atomic<size_t> finished_pairs = 0;
+    const size_t print_interval = std::max<size_t>(1, num_pairs / 100);
+#pragma omp parallel num_threads(num_threads)
+    {
+        const int thread_id = omp_get_thread_num();
+        ScopedPerfStage perf_stage("compute_mappings", thread_id);
+        const ScopedAffinityRestore affinity;
+        const int node = topology.NodeOfThread(thread_id);
+        // pinning fails (and is not needed) on single-node machines
+        [[maybe_unused]] const bool pinned = topology.PinCurrentThread(node);
+        const SharedGraphStore& replica = *replicas.ForNode(node);
+
+        std::unique_ptr<ged::GEDEnv<ged::LabelID, ged::LabelID, ged::LabelID>> worker_env;
+        if (all_graphs) {
+            worker_env = std::make_unique<ged::GEDEnv<ged::LabelID, ged::LabelID, ged::LabelID>>();
+            InitializeGEDEnvironmentFromStore(*worker_env, replica, {}, edit_cost, ged_method, method_options);
+        }
+        // allocated after pinning, hence first-touched on the node of this worker
+        std::vector<GEDEvaluation<UDataGraph>> local_results;
+        size_t checkpointed = 0;
+        for (size_t i = next_pair++; i < num_pairs; i = next_pair++) {
+            const auto [source_id, target_id] = graph_pairs[i];
+            if (worker_env) {
+                {
+                    // only held during the solve, the other threads keep running heuristics meanwhile
+                    SolverSlotGuard slot(ged_method, method_options);
+                    worker_env->run_method(source_id, target_id);
+                }
+                local_results.emplace_back(ComputeGEDResult(*worker_env, graphs, source_id, target_id));
+            }
+            else {
+                const StorePairView pair_view(replica, source_id, target_id);
+                auto ged_env = ged::GEDEnv<ged::LabelID, ged::LabelID, ged::LabelID>();
+                InitializeGEDEnvironmentFromStore(ged_env, pair_view, {}, edit_cost, ged_method, method_options);
+                {
+                    SolverSlotGuard slot(ged_method, method_options);
+                    ged_env.run_method(0, 1);
+                }
+                local_results.emplace_back(pair_environment_result(ged_env, graphs.graphData[source_id], graphs.graphData[target_id], source_id, target_id));
+            }
+            if (local_results.size() - checkpointed >= print_interval) {
+                // a failed checkpoint only costs the resume, the results stay in memory
+                const std::string name = "numa_" + std::to_string(thread_id) + "_" + std::to_string(thread_checkpoints[thread_id].size());
+                if (write_tmp_mappings(output_path, db, name, std::vector<GEDEvaluation<UDataGraph>>(local_results.begin() + checkpointed, local_results.end()))) {
+                    thread_checkpoints[thread_id].emplace_back(tmp_mapping_file(output_path, db, name));
+                    checkpointed = local_results.size();
+                }
+            }
+            if (const size_t finished = ++finished_pairs; finished % print_interval == 0 || finished == num_pairs) {
+#pragma omp critical
+                std::cout << "Computed " << finished << " of " << num_pairs << " GED mappings" << std::endl;
+            }
+        }
+        thread_results[thread_id] = std::move(local_results);
+    }
+    std::vector<std::filesystem::path> checkpoints;
+    for (int thread_id = 0; thread_id < num_threads; ++thread_id) {
+        auto& local_results = thread_results[thread_id];
+        results.insert(results.end(), std::make_move_iterator(local_results.begin()), std::make_move_iterator(local_results.end()));
+        checkpoints.insert(checkpoints.end(), thread_checkpoints[thread_id].begin(), thread_checkpoints[thread_id].end());
+    }
+    return checkpoints;
+}
+
+// Random distinct graph pairs (smaller id first) in sampling order, the same seed always gives the same sequence.
+// If graph_ids (sorted subset) is not empty, both graphs of every pair are drawn from it.
+inline std::vector<std::pair<INDEX, INDEX>> sample_graph_pairs(INDEX num_graphs, size_t max_number_of_pairs, int seed, const std::vector<INDEX>& graph_ids = {}) {
+    std::vector<std::pair<INDEX, INDEX>> graph_pairs;
+    if (!graph_ids.empty()) {
+        num_graphs = graph_ids.size();
+    }
+    if (num_graphs < 2) {
+        return graph_pairs;
+    }
+    // store pairs inside set for faster lookup
+    std::set<std::pair<INDEX, INDEX>> g_pairs;
+    // set up random device
+    auto gen = std::mt19937(seed);
+    std::uniform_int_distribution<INDEX> dist(0, num_graphs - 1);
+    while (g_pairs.size() < max_number_of_pairs && g_pairs.size() != num_graphs * (num_graphs - 1) / 2) {
+        // get random integer between 0 and num_graphs - 1
+        INDEX id1 = dist(gen);
+        INDEX id2 = dist(gen);
+        if (!graph_ids.empty()) {
+            id1 = graph_ids[id1];
+            id2 = graph_ids[id2];
+        }
+        if (id1 != id2) {
+            std::pair<INDEX, INDEX> pair = std::minmax(id1, id2);
+            auto [fst, snd] = g_pairs.insert(pair);
+            if (snd) {
+                graph_pairs.emplace_back(pair);
+            }
+        }
+    }
+    return graph_pairs;
+}
+
+// Compute one pair in an environment that only holds its two graphs
+inline GEDEvaluation<UDataGraph> create_edit_mapping_pair(const GraphPairView& pair_view, INDEX source_id, INDEX target_id,
+                                                          ged::Options::EditCosts edit_cost,
+                                                          ged::Options::GEDMethod ged_method,
+                                                          const std::string& method_options) {
+    auto ged_env = ged::GEDEnv<ged::LabelID, ged::LabelID, ged::LabelID>();
+    InitializeGEDEnvironmentFromStore(ged_env, pair_view, {}, edit_cost, ged_method, method_options);
+    {
+        SolverSlotGuard slot(ged_method, method_options);
+        ged_env.run_method(0, 1);
+    }
+    return pair_environment_result(ged_env, pair_view, source_id, target_id);
+}
+
+// Out-of-core mapping computation: the graphs are never loaded as a whole, every pair is computed in a small
+// environment with the two graphs fetched from the disk-backed store. The pairs are processed in cache-friendly
+// tile order, each worker gets a contiguous range of tiles.
+inline int create_edit_mappings_lazy(const std::string& db,
+                                     const std::string& output_path,
+                                     const std::string& processed_graph_path,
+                                     size_t cache_graphs,
+                                     ged::Options::EditCosts edit_cost,
+                                     ged::Options::GEDMethod ged_method,
+                                     const std::string& method_options,
+                                     const std::string& graph_ids_path,
+                                     const std::string& pairs_file,
+                                     int num_pairs,
+                                     int num_threads,
+                                     int seed) {
+    const std::string mapping_file = output_path + db + "/" + db + "_ged_mapping.bin";
+    if (std::filesystem::exists(mapping_file)) {
+        std::cerr << "Mapping file " << mapping_file << " already exists, extending existing mappings needs the dataset in memory (run without -lazy_cache)" << std::endl;
+        return 1;
+    }
+    if (InitializesOnAllGraphs(ged_method, method_options)) {
+        std::cerr << "The method trains on all graphs of the dataset, which needs the dataset in memory (run without -lazy_cache)" << std::endl;
+        return 1;
+    }
+    ScopedPerfStage index_stage("index_graphs");
+    auto store = LazyGraphStore::Open(processed_graph_path + db + ".bgf", cache_graphs);
+    if (!store) {
+        return 1;
+    }
+    index_stage.Stop();
+    std::cout << "Indexed " << store->size() << " graphs, loading them on demand" << std::endl;
+    // only the graphs of the selected pairs are ever read from disk
+    std::vector<INDEX> subset_ids;
+    std::vector<std::pair<INDEX, INDEX>> graph_pairs;
+    if (!load_pair_selection(graph_ids_path, pairs_file, store->size(), subset_ids, graph_pairs)) {
+        return 1;
+    }
+    if (pairs_file.empty()) {
+        graph_pairs = sample_graph_pairs(store->size(), num_pairs < 0 ? 1000000 : num_pairs, seed, subset_ids);
+    }
+    num_threads = std::max(1, num_threads);
+    OrderPairsForCache(graph_pairs, store->cache_capacity() / num_threads);
+    std::cout << "Number of GED mappings to compute: " << graph_pairs.size() << std::endl;
+
+    std::vector<std::vector<GEDEvaluation<UDataGraph>>> thread_results(num_threads);
+    std::atomic<size_t> finished_pairs = 0;
+    std::atomic<bool> read_failed = false;
+    const size_t print_interval = std::max<size_t>(1, graph_pairs.size() / 100);
+#pragma omp parallel num_threads(num_threads)
+    {
+        ScopedPerfStage perf_stage("compute_mappings", omp_get_thread_num());
+#pragma omp for schedule(static)
+        for (size_t i = 0; i < graph_pairs.size(); ++i) {
+            const auto [source_id, target_id] = graph_pairs[i];
+            const auto source = store->Get(source_id);
+            const auto target = store->Get(target_id);
+            // read errors are reported after the parallel region
+            if (!source || !target) {
+                read_failed = true;
+                continue;
+            }
+            const GraphPairView pair_view(*source, *target);
+            thread_results[omp_get_thread_num()].emplace_back(create_edit_mapping_pair(pair_view, source_id, target_id, edit_cost, ged_method, method_options));
+            if (const size_t finished = ++finished_pairs; finished % print_interval == 0 || finished == graph_pairs.size()) {
+#pragma omp critical
+                std::cout << "Computed " << finished << " of " << graph_pairs.size() << " GED mappings" << std::endl;
+            }
+        }
+    }
+    store->PrintCacheStatistics();
+    if (read_failed) {
+        std::cerr << "Could not read all graphs of the pairs from " << processed_graph_path + db + ".bgf" << ", no mappings written" << std::endl;
+        return 1;
+    }
+
+    std::vector<GEDEvaluation<UDataGraph>> results;
+    for (auto& local_results : thread_results) {
+        results.insert(results.end(), std::make_move_iterator(local_results.begin()), std::make_move_iterator(local_results.end()));
+    }
+    ranges::sort(results, [](const GEDEvaluation<UDataGraph>& a, const GEDEvaluation<UDataGraph>& b) {
+        return a.graph_ids < b.graph_ids;
+    });
+    // repair invalid mappings in two-graph environments, as they were computed
+    ScopedPerfStage fix_stage("fix_invalid_mappings");
+    fixInvalidMappings(results, ged_method, method_options, [&](INDEX source_id, INDEX target_id, ged::Options::GEDMethod method, const std::string& options) -> std::optional<GEDEvaluation<UDataGraph>> {
+        const auto source = store->Get(source_id);
+        const auto target = store->Get(target_id);
+        if (!source || !target) {
+            return std::nullopt;
+        }
+        auto result = create_edit_mapping_pair(GraphPairView(*source, *target), source_id, target_id, edit_cost, method, options);
+        print_mapping(source_id, target_id, result.distance, result.lower_bound, result.upper_bound, result.node_mapping.first, result.node_mapping.second);
+        return result;
+    });
+    fix_stage.Stop();
+    ScopedPerfStage write_stage("write_mappings");
+    WriteMappingStore(output_path + db + "/", db, results);
+    CSVFromGEDResults(output_path + db + "/" + db + "_ged_mapping.csv", results);
+    return 0;
+}
+
 inline void get_existing_mappings(const std::string& output_path,
                                   const std::string& db,
                                   GraphData<UDataGraph>& graphs,
@@ -181,7 +565,7 @@ inline void get_existing_mappings(const std::string& output_path,
         }
     }
     // save the updated results back to binary
-    GEDResultToBinary(output_path + "/" + db + "/", results);
+    WriteMappingStore(output_path + "/" + db + "/", db, results);
 }
 
 inline void fix_invalid_mappings(const std::string& output_path,
@@ -195,9 +579,39 @@ inline void fix_invalid_mappings(const std::string& output_path,
     // load merged results
     auto results = std::vector<GEDEvaluation<UDataGraph>>{};
     BinaryToGEDResult(mapping_file, graphs, results);
-    fixInvalidMappings(results, graphs, edit_cost, ged_method, method_options);
+    const SharedGraphStore store(graphs);
+    fixInvalidMappings(results, graphs, store, edit_cost, ged_method, method_options);
     // save the updated results back to binary
-    GEDResultToBinary(output_path + "/" + db + "/", results);
+    WriteMappingStore(output_path + "/" + db + "/", db, results);
+}
+
+// Graphs a run restricted by -ids_path/-pairs_file needs: the graphs of the selection and those of the existing mappings,
+// whose ids are taken from the mapping index. Returns false if the ids of existing mappings are only known after reading
+// them with the whole dataset (a mapping file without a current index, or tmp files that are not merged yet).
+inline bool selection_graph_ids(const std::string& output_path,
+                                const std::string& db,
+                                const std::vector<INDEX>& subset_ids,
+                                const std::vector<std::pair<INDEX, INDEX>>& explicit_pairs,
+                                const std::string& pairs_file,
+                                std::vector<INDEX>& graph_ids) {
+    const std::string tmp_path = output_path + db + "/tmp/";
+    if (std::filesystem::exists(tmp_path) && !std::filesystem::is_empty(tmp_path)) {
+        return false;
+    }
+    graph_ids = pairs_file.empty() ? subset_ids : ReferencedGraphIds(explicit_pairs);
+    if (std::filesystem::exists(output_path + "/" + db + "/" + db + "_ged_mapping.bin")) {
+        const auto index = MappingIndex::Open(output_path + "/" + db + "/", db);
+        if (!index) {
+            return false;
+        }
+        for (uint64_t ordinal = 0; ordinal < index->size(); ++ordinal) {
+            graph_ids.push_back(index->record(ordinal).source_id);
+            graph_ids.push_back(index->record(ordinal).target_id);
+        }
+        std::ranges::sort(graph_ids);
+        graph_ids.erase(std::unique(graph_ids.begin(), graph_ids.end()), graph_ids.end());
+    }
+    return true;
 }
 
 inline int create_edit_mappings(const std::string& db,
@@ -208,28 +622,98 @@ inline int create_edit_mappings(const std::string& db,
                                 ged::Options::GEDMethod ged_method,
                                 const std::string& method_options,
                                 const std::string& graph_ids_path,
+                                const std::string& pairs_file,
                                 int num_pairs,
                                 int num_threads,
                                 int seed,
                                 int single_source,
-                                int single_target) {
+                                int single_target,
+                                bool numa,
+                                const std::string& shm_name,
+                                const std::string& shm_publish,
+                                size_t lazy_cache_graphs,
+                                bool batched_bipartite) {
+    // multi-process worker: everything comes from the shared-memory segment of the coordinator
+    if (!shm_name.empty()) {
+        if (single_source < 0 || single_target < 0) {
+            std::cerr << "-shm is the worker mode for single pairs and needs -single_source and -single_target" << std::endl;
+            return 1;
+        }
+        const auto shm_store = ShmGraphStore::Attach(shm_name);
+        if (!shm_store) {
+            return 1;
+        }
+        return create_edit_mappings_single_shm(output_path, db, single_source, single_target, *shm_store, edit_cost, ged_method, method_options);
+    }
 
     
+    ScopedPerfStage preprocess_stage("preprocess_graphs");
     if (const bool success = LoadSaveGraphDatasets::PreprocessTUDortmundGraphData(db, input_path, processed_graph_path); !success) {
         std::cout << "Failed to create TU dataset" << std::endl;
         return 1;
     }
+    preprocess_stage.Stop();
+    // datasets larger than the memory: work on the preprocessed file through a bounded graph cache
+    if (lazy_cache_graphs > 0) {
+        return create_edit_mappings_lazy(db, output_path, processed_graph_path, lazy_cache_graphs, edit_cost, ged_method, method_options, graph_ids_path, pairs_file, num_pairs, num_threads, seed);
+    }
+    ScopedPerfStage load_stage("load_graphs");
     GraphData<UDataGraph> graphs;
-    LoadSaveGraphDatasets::LoadPreprocessedTUDortmundGraphData(db, processed_graph_path, graphs);
+    // restrict the computation to a graph id subset (-ids_path) and/or an explicit list of pairs (-pairs_file)
+    std::vector<INDEX> subset_ids;
+    std::vector<std::pair<INDEX, INDEX>> explicit_pairs;
+    bool selection_loaded = false;
+    bool all_graphs_loaded = true;
+    // with a selection only its graphs (and those of the existing mappings) are read. The shared-memory coordinator,
+    // single pairs and methods that train on all graphs need the whole dataset.
+    if ((!graph_ids_path.empty() || !pairs_file.empty()) && shm_publish.empty() && (single_source < 0 || single_target < 0)
+        && !InitializesOnAllGraphs(ged_method, method_options)) {
+        const auto index = BGFIndex::Open(processed_graph_path + db + ".bgf");
+        if (!index || !load_pair_selection(graph_ids_path, pairs_file, index->size(), subset_ids, explicit_pairs)) {
+            return 1;
+        }
+        selection_loaded = true;
+        if (std::vector<INDEX> graph_ids; selection_graph_ids(output_path, db, subset_ids, explicit_pairs, pairs_file, graph_ids)) {
+            if (!LoadGraphsById(*index, graph_ids, graphs)) {
+                return 1;
+            }
+            all_graphs_loaded = false;
+            std::cout << "Loaded " << graph_ids.size() << " of " << index->size() << " graphs (selection and existing mappings)" << std::endl;
+        }
+        else {
+            std::cout << "Existing mappings without a current mapping index or unmerged tmp files, loading all graphs" << std::endl;
+        }
+    }
+    if (all_graphs_loaded) {
+        LoadSaveGraphDatasets::LoadPreprocessedTUDortmundGraphData(db, processed_graph_path, graphs);
+    }
+    // one read-only copy of the dataset shared by all GED environments created below (in addition to graphs, which
+    // libGraph needs for the results and the merge of the tmp files)
+    const auto store = std::make_shared<const SharedGraphStore>(graphs);
+    load_stage.Stop();
+    std::cout << "Shared graph store: " << store->size() << " graphs, " << store->MemoryBytes() / (1024.0 * 1024.0) << " MB" << std::endl;
+    // cached next to the preprocessed graphs, only recomputed if the graphs changed (needs all graphs)
+    if (all_graphs_loaded) {
+        ScopedPerfStage features_stage("graph_features");
+        const GraphFeatures features = GraphFeatures::LoadOrCompute(processed_graph_path, db, *store);
+        features_stage.Stop();
+        features.Print();
+    }
     std::vector<std::pair<INDEX, INDEX>> graph_pairs;
     std::vector<std::pair<INDEX, INDEX>> existing_pairs;
 
     auto results = std::vector<GEDEvaluation<UDataGraph>>{};
+    ScopedPerfStage existing_stage("load_existing_mappings");
     get_existing_mappings(output_path, db, graphs, existing_pairs, results);
-    fixInvalidMappings(results, graphs, edit_cost, ged_method, method_options);
+    fixInvalidMappings(results, graphs, *store, edit_cost, ged_method, method_options);
+    existing_stage.Stop();
     // save the updated results back to binary
-    GEDResultToBinary(output_path + "/" + db + "/", results);
+    WriteMappingStore(output_path + "/" + db + "/", db, results);
 
+    // coordinator of a multi-process run: publish graphs and mappings once, the workers attach with -shm
+    if (!shm_publish.empty()) {
+        return ShmGraphStore::Publish(shm_publish, *store, results) ? 0 : 1;
+    }
 
         // If db_ged_mapping.bin already exists load it and look for existing graph ids
 
@@ -239,83 +723,120 @@ inline int create_edit_mappings(const std::string& db,
 
     // If single_source and single_target are set, only compute and print that mapping
     if (single_source >= 0 && single_target >= 0) {
-        auto result = create_edit_mappings_single(single_source, single_target, graphs, edit_cost, ged_method, method_options, true);
+        auto result = create_edit_mappings_single(single_source, single_target, graphs, *store, edit_cost, ged_method, method_options, true);
         return 0;
     }
 
-    // Else generate random pairs (a large number)
-    size_t max_number_of_pairs = 1000000;
-    // store pairs inside set for faster lookup
-    std::set<std::pair<INDEX, INDEX>> g_pairs;
-    // set up random device
-    auto gen = std::mt19937(seed);
-    std::uniform_int_distribution<INDEX> dist(0, graphs.graphData.size() - 1);
-    while (g_pairs.size() < max_number_of_pairs && g_pairs.size() != graphs.graphData.size() * (graphs.graphData.size() - 1) / 2) {
-        // get random integer between 0 and graphs.GraphData.size() - 1
-        INDEX id1 = dist(gen);
-        // id2 should between id1 + 1 and graphs.GraphData.size() - 1
-        INDEX id2 = dist(gen);
-        if (id1 != id2) {
-            std::pair<INDEX, INDEX> pair = std::minmax(id1, id2);
-            auto [fst, snd] = g_pairs.insert(pair);
-            if (snd) {
-                graph_pairs.emplace_back(pair);
-            }
-        }
+    if (!selection_loaded && !load_pair_selection(graph_ids_path, pairs_file, graphs.graphData.size(), subset_ids, explicit_pairs)) {
+        return 1;
     }
-    // if there are not enough existing pairs (computation has been interrupted) and num_pairs is set, only generate that many pairs
     std::vector<std::pair<INDEX, INDEX>> next_graph_pairs;
-    // iterate through the graph pairs and add those to next_graph_pairs that are not in existing_pairs
-    // get the last index in graph_pairs that is bigger than an entry occuring in existing_pairs (to avoid unnecessary iterations)
-    size_t max_index = 0;
-    for (const auto& pair : existing_pairs) {
-        auto it = ranges::find(graph_pairs, pair);
-        if (it != graph_pairs.end()) {
-            size_t index = std::distance(graph_pairs.begin(), it);
-            if (index > max_index) {
-                max_index = index;
+    size_t number_of_pairs_to_compute = 0;
+    if (!pairs_file.empty()) {
+        // explicit pairs: compute every listed pair that has no mapping yet
+        const std::set<std::pair<INDEX, INDEX>> existing(existing_pairs.begin(), existing_pairs.end());
+        for (const auto& pair : explicit_pairs) {
+            if (!existing.contains(pair)) {
+                next_graph_pairs.emplace_back(pair);
             }
         }
+        number_of_pairs_to_compute = next_graph_pairs.size();
     }
-    // iterate over graph_pairs starting with max_index + 1
-    for (size_t index = max_index + 1; index < graph_pairs.size(); ++index) {
-        const auto& pair = graph_pairs[index];
-        if (ranges::find(existing_pairs, pair) == existing_pairs.end()) {
-            next_graph_pairs.emplace_back(pair);
+    else {
+        // Else generate random pairs (a large number)
+        graph_pairs = sample_graph_pairs(graphs.graphData.size(), 1000000, seed, subset_ids);
+        // if there are not enough existing pairs (computation has been interrupted) and num_pairs is set, only generate that many pairs
+        // iterate through the graph pairs and add those to next_graph_pairs that are not in existing_pairs
+        // get the last index in graph_pairs that is bigger than an entry occuring in existing_pairs (to avoid unnecessary iterations)
+        size_t max_index = 0;
+        for (const auto& pair : existing_pairs) {
+            auto it = ranges::find(graph_pairs, pair);
+            if (it != graph_pairs.end()) {
+                size_t index = std::distance(graph_pairs.begin(), it);
+                if (index > max_index) {
+                    max_index = index;
+                }
+            }
         }
+        // iterate over graph_pairs starting with max_index + 1
+        for (size_t index = max_index + 1; index < graph_pairs.size(); ++index) {
+            const auto& pair = graph_pairs[index];
+            if (ranges::find(existing_pairs, pair) == existing_pairs.end()) {
+                next_graph_pairs.emplace_back(pair);
+            }
+        }
+        // only existing mappings inside of the subset count towards num_pairs
+        std::vector<std::pair<INDEX, INDEX>> existing_in_subset = existing_pairs;
+        restrict_pairs_to_subset(existing_in_subset, subset_ids);
+        const size_t requested_pairs = num_pairs < 0 ? graph_pairs.size() : static_cast<size_t>(num_pairs);
+        number_of_pairs_to_compute = requested_pairs > existing_in_subset.size() ? requested_pairs - existing_in_subset.size() : 0;
     }
 
     // std::cout number of pairs to compute
-    std::cout << "Number of GED mappings to compute: " << num_pairs - existing_pairs.size() << std::endl;
-    size_t number_of_pairs_to_compute = num_pairs - existing_pairs.size();
+    std::cout << "Number of GED mappings to compute: " << number_of_pairs_to_compute << std::endl;
     if (number_of_pairs_to_compute == 0) {
         std::cout << "All requested GED mappings already exist. Exiting." << std::endl;
         return 0;
     }
 
     graph_pairs = next_graph_pairs;
+    // a small subset may have fewer distinct pairs than requested
+    number_of_pairs_to_compute = std::min(number_of_pairs_to_compute, graph_pairs.size());
 
     // Ensure base tmp directory exists
     std::filesystem::path base_tmp = output_path + db + "/tmp/";
     std::filesystem::create_directories(base_tmp);
 
-    // If threads is one do not chunk
-
-    auto ged_env = ged::GEDEnv<ged::LabelID, ged::LabelID, ged::LabelID>();
-    InitializeGEDEnvironment(ged_env, graphs, edit_cost, ged_method, method_options);
-    ComputeGEDResults(ged_env, graphs, graph_pairs, number_of_pairs_to_compute, base_tmp.string(), ged_method, method_options);
-
+    // tmp files of the NUMA workers, removed once their mappings are part of the written mapping file
+    std::vector<std::filesystem::path> numa_checkpoints;
+    if (batched_bipartite) {
+        // native engine for bulk BIPARTITE upper bounds, no GED environment needed
+        ScopedPerfStage perf_stage("compute_mappings");
+        BipartiteEditCosts costs;
+        if (!BipartiteEditCosts::For(edit_cost, costs)) {
+            std::cerr << "-batched_bipartite only supports the CONSTANT edit costs" << std::endl;
+            return 1;
+        }
+        const BatchedBipartite engine(*store, costs);
+        auto new_results = engine.Compute(graphs, graph_pairs, number_of_pairs_to_compute, num_threads);
+        results.insert(results.end(), std::make_move_iterator(new_results.begin()), std::make_move_iterator(new_results.end()));
+    }
+    else if (numa) {
+        const NumaTopology topology = NumaTopology::Detect();
+        topology.PrintTopology();
+        const NumaGraphReplicas replicas(topology, store);
+        numa_checkpoints = ComputeGEDResultsNuma(output_path, db, graphs, topology, replicas, graph_pairs, number_of_pairs_to_compute, num_threads, edit_cost, ged_method, method_options, results);
+    }
+    else {
+        // GEDLIB runs the pairs on its OpenMP threads. These are not counted (a pool that already exists is never
+        // inherited, and new threads only add their counts when they exit), so the counters cover the calling thread only.
+        ScopedPerfStage perf_stage("compute_mappings");
+        auto ged_env = ged::GEDEnv<ged::LabelID, ged::LabelID, ged::LabelID>();
+        InitializeGEDEnvironmentFromStore(ged_env, *store, ReferencedGraphIds(graph_pairs, number_of_pairs_to_compute), edit_cost, ged_method, method_options);
+        {
+            // the pair loop runs inside libGraph, so this process holds one slot per GEDLIB thread (--threads) for all of it
+            SolverSlotGuard slot(ged_method, method_options);
+            ComputeGEDResults(ged_env, graphs, graph_pairs, number_of_pairs_to_compute, base_tmp.string(), ged_method, method_options);
+        }
 
-    std::string search_string = "_ged_mapping";
-    MergeGEDResults(output_path + db + "/tmp/", output_path + db + "/", search_string, graphs);
-    // load mappings
-    results.clear();
-    BinaryToGEDResult(output_path + db + "/" + db + "_ged_mapping.bin", graphs, results);
+        std::string search_string = "_ged_mapping";
+        MergeGEDResults(output_path + db + "/tmp/", output_path + db + "/", search_string, graphs);
+        // load mappings
+        results.clear();
+        BinaryToGEDResult(output_path + db + "/" + db + "_ged_mapping.bin", graphs, results);
+    }
     // Fix invalid mappings that are still present (due to parallel execution issues in gedlib)
-    fixInvalidMappings(results, graphs, edit_cost, ged_method, method_options);
+    ScopedPerfStage fix_stage("fix_invalid_mappings");
+    fixInvalidMappings(results, graphs, *store, edit_cost, ged_method, method_options);
+    fix_stage.Stop();
     // save the updated results back to binary
-    GEDResultToBinary(output_path + "/" + db + "/", results);
+    ScopedPerfStage write_stage("write_mappings");
+    WriteMappingStore(output_path + "/" + db + "/", db, results);
     CSVFromGEDResults(output_path + db + "/" + db + "_ged_mapping.csv", results);
+    for (const auto& checkpoint : numa_checkpoints) {
+        std::error_code error;
+        std::filesystem::remove(checkpoint, error);
+    }
 
     return 0;
 }
@@ -6,6 +6,11 @@
 #define GEDPATHS_CREATE_EDIT_PATHS_H
 
 #include <libGraph.h>
+#include "src/perf_counters.h"
+#include "src/mapping_store.h"
+#include "src/pair_selection.h"
+#include "src/bgf_index.h"
+#include "src/graph_features.h"
 
 inline int create_edit_paths( const std::string& db,
                               const std::string& processed_graph_path,
@@ -17,8 +22,11 @@ inline int create_edit_paths( const std::string& db,
                               const bool connected_only = false,
                               const std::vector<std::string>& path_strategies = {"Random"},
                               const int source_id = -1,
-                              const int target_id = -1) {
-        std::vector<EditPathStrategy> edit_path_strategies = StringsToEditPathStrategies(path_strategies);
+                              const int target_id = -1,
+                              const MappingSelection& selection = {},
+                              const bool lazy = false,
+                              const bool distinct_only = false) {
+    std::vector<EditPathStrategy> edit_path_strategies = StringsToEditPathStrategies(path_strategies);
     if (!GetValidStrategy(edit_path_strategies)) {
         std::cerr << "Error: Invalid edit path strategies specified." << std::endl;
         return 1;
@@ -39,15 +47,105 @@ inline int create_edit_paths( const std::string& db,
         std::filesystem::create_directories(edit_path_output_db);
     }
 
+    // -distinct_only drops the mappings between graphs with equal WL hash (duplicates of the dataset, their paths are
+    // empty or trivial), decided by the graph features of CreateMappings without touching the graphs
+    GraphFeatures features;
+    if (distinct_only && !GraphFeatures::Load(processed_graph_path, db, features)) {
+        std::cerr << "-distinct_only needs the graph features " << GraphFeatureFile(processed_graph_path, db) << " of the current graphs, run CreateMappings first" << std::endl;
+        return 1;
+    }
+    auto is_duplicate = [&](INDEX source, INDEX target) {
+        return distinct_only && source < features.size() && target < features.size() && features.wl_hash(source) == features.wl_hash(target);
+    };
+
+    // with -lazy only the graphs of the selected mappings are read from the preprocessed file (after the selection)
     GraphData<UDataGraph> graphs;
-    LoadSaveGraphDatasets::LoadPreprocessedTUDortmundGraphData(db, processed_graph_path, graphs);
+    if (!lazy) {
+        ScopedPerfStage load_stage("load_graphs");
+        LoadSaveGraphDatasets::LoadPreprocessedTUDortmundGraphData(db, processed_graph_path, graphs);
+    }
 
 
+    // selections, single pairs and -lazy are answered by the mapping index, only the selected mappings are decoded
+    const bool single_pair = source_id >= 0 && target_id >= 0;
+    if (selection.active() || single_pair || lazy) {
+        ScopedPerfStage select_stage("select_mappings");
+        auto index = MappingIndex::Open(mappings_path, db);
+        if (!index && lazy) {
+            std::cerr << "-lazy needs the mapping index " << MappingIndexFile(mappings_path, db) << ", run once without -lazy to build it" << std::endl;
+            return 1;
+        }
+        if (!index && selection.active()) {
+            // mappings written before the index existed: build it once from the full mapping file
+            std::cout << "Building the mapping index for " << MappingFile(mappings_path, db) << std::endl;
+            std::vector<GEDEvaluation<UDataGraph>> all_results;
+            BinaryToGEDResult(MappingFile(mappings_path, db), graphs, all_results);
+            WriteMappingIndex(mappings_path, db, all_results, MappingValidity(all_results));
+            index = MappingIndex::Open(mappings_path, db);
+            if (!index) {
+                std::cerr << "Could not build the mapping index in " << mappings_path << std::endl;
+                return 1;
+            }
+        }
+        if (index) {
+            std::vector<uint64_t> ordinals;
+            if (single_pair) {
+                if (const int64_t ordinal = index->Find(source_id, target_id); ordinal >= 0) {
+                    ordinals.push_back(ordinal);
+                }
+            }
+            else {
+                // without predicates this selects all valid mappings
+                ordinals = SelectMappings(*index, selection, seed);
+                std::erase_if(ordinals, [&](uint64_t ordinal) { return is_duplicate(index->record(ordinal).source_id, index->record(ordinal).target_id); });
+                // -num_mappings limits the selected mappings like it limits the valid mappings below
+                if (num_mappings > 0 && num_mappings < static_cast<int>(ordinals.size())) {
+                    std::ranges::shuffle(ordinals, std::mt19937(seed));
+                    ordinals.resize(num_mappings);
+                    std::ranges::sort(ordinals);
+                }
+            }
+            if (lazy) {
+                std::vector<std::pair<INDEX, INDEX>> selected_pairs;
+                selected_pairs.reserve(ordinals.size());
+                for (const uint64_t ordinal : ordinals) {
+                    selected_pairs.emplace_back(index->record(ordinal).source_id, index->record(ordinal).target_id);
+                }
+                const std::string graph_file = processed_graph_path + db + ".bgf";
+                select_stage.Stop();
+                ScopedPerfStage load_stage("load_graphs");
+                const auto graph_index = BGFIndex::Open(graph_file);
+                const std::vector<INDEX> graph_ids = ReferencedGraphIds(selected_pairs);
+                if (!graph_index || !LoadGraphsById(*graph_index, graph_ids, graphs)) {
+                    std::cerr << "Could not read the graphs of the selected mappings from " << graph_file << std::endl;
+                    return 1;
+                }
+                std::cout << "Read " << graph_ids.size() << " of " << graph_index->size() << " graphs from " << graph_file << ".\n";
+            }
+            std::vector<GEDEvaluation<UDataGraph>> selected_results;
+            selected_results.reserve(ordinals.size());
+            for (const uint64_t ordinal : ordinals) {
+                selected_results.emplace_back(index->Decode(ordinal, graphs));
+            }
+            std::cout << "Selected " << selected_results.size() << " of " << index->size() << " mappings using the mapping index.\n";
+            if (selected_results.empty()) {
+                std::cerr << "No mappings match the selection. Exiting.\n";
+                return 1;
+            }
+            select_stage.Stop();
+            ScopedPerfStage paths_stage("create_edit_paths");
+            CreateAllEditPaths(selected_results, graphs,  edit_path_output_db, seed, connected_only, edit_path_strategies);
+            return 0;
+        }
+    }
+
     // load mappings
+    ScopedPerfStage mappings_stage("load_mappings");
     std::vector<GEDEvaluation<UDataGraph>> results;
     BinaryToGEDResult(mappings_path + db + "_ged_mapping.bin", graphs, results);
     // Check validity and collect invalid result ids
     auto invalids = CheckResultsValidity(results);
+    mappings_stage.Stop();
     if (!invalids.empty()) {
         std::cerr << "Warning: Found invalid mappings for the following result ids (these will be skipped):\n";
         for (const auto &id : invalids) {
@@ -59,10 +157,10 @@ inline int create_edit_paths( const std::string& db,
     }
 
 
-    // Filter out invalid results
+    // Filter out invalid results (and with -distinct_only the duplicate pairs)
     std::vector<GEDEvaluation<UDataGraph>> valid_results;
     for (size_t i = 0; i < results.size(); ++i) {
-        if (std::find(invalids.begin(), invalids.end(), static_cast<int>(i)) == invalids.end()) {
+        if (std::find(invalids.begin(), invalids.end(), static_cast<int>(i)) == invalids.end() && !is_duplicate(results[i].graph_ids.first, results[i].graph_ids.second)) {
             valid_results.push_back(results[i]);
         }
     }
@@ -98,11 +196,13 @@ inline int create_edit_paths( const std::string& db,
         }
         std::vector<GEDEvaluation<UDataGraph>> single_result{*it};
         std::cout << "Erzeuge Edit-Path nur für Mapping zwischen Graph " << source_id << " und " << target_id << ".\n";
+        ScopedPerfStage paths_stage("create_edit_paths");
         CreateAllEditPaths(single_result, graphs,  edit_path_output_db, seed, connected_only, edit_path_strategies);
         return 0;
     }
     // print info about number of valid results considered
     std::cout << "Creating edit paths for " << valid_results.size() << " valid mappings out of " << results.size() << " total mappings.\n";
+    ScopedPerfStage paths_stage("create_edit_paths");
     CreateAllEditPaths(valid_results, graphs,  edit_path_output_db, seed, connected_only, edit_path_strategies);
 
     return 0;
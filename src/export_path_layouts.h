@@ -0,0 +1,685 @@
+// Path-consistent layouts of edit paths for the plotting scripts. All graphs of a path get their node positions
+// from one Fruchterman-Reingold layout of the union graph of the path (source and target graph glued together by
+// the stored node mapping of the pair, i.e. every node and edge that occurs in any step). Each step starts from the positions of the
+// previous step and is only refined by a few cooled iterations with a small step size, so nodes keep their place while the path is edited.
+// The positions and the changes between consecutive steps are written to a compact binary file (<db>_path_layouts.bin).
+
+#ifndef GEDPATHS_EXPORT_PATH_LAYOUTS_H
+#define GEDPATHS_EXPORT_PATH_LAYOUTS_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <omp.h>
+#include <libGraph.h>
+#include "src/analyze_edit_path_graphs.h"
+#include "src/bgf_index.h"
+#include "src/mapping_store.h"
+#include "src/pair_selection.h"
+#include "src/perf_counters.h"
+
+constexpr uint64_t PATH_LAYOUTS_MAGIC = 0x54554f59414c5047ULL; // "GPLAYOUT"
+constexpr uint32_t PATH_LAYOUTS_VERSION = 1;
+constexpr uint32_t PATH_LAYOUT_NO_NODE = std::numeric_limits<uint32_t>::max();
+
+enum class PathDeltaType : uint8_t {
+    NODE_INSERT = 0,
+    NODE_DELETE = 1,
+    NODE_RELABEL = 2,
+    EDGE_INSERT = 3,
+    EDGE_DELETE = 4,
+    EDGE_RELABEL = 5,
+};
+
+// Change between two consecutive graphs of a path, a and b are union node ids (b is PATH_LAYOUT_NO_NODE for nodes)
+struct PathDelta {
+    PathDeltaType type = PathDeltaType::NODE_INSERT;
+    uint32_t a = 0;
+    uint32_t b = PATH_LAYOUT_NO_NODE;
+};
+
+struct PathLayout {
+    INDEX source_id = 0;
+    INDEX target_id = 0;
+    uint32_t union_nodes = 0;
+    // per step: union node id and position of every node of the step graph (in the node order of the step graph)
+    std::vector<std::vector<uint32_t>> step_nodes;
+    std::vector<std::vector<std::array<float, 2>>> step_positions;
+    // per step: changes from the previous step (empty for the source graph)
+    std::vector<std::vector<PathDelta>> step_deltas;
+};
+
+// Union graph of an edit path, built from the node mapping of its pair: every source node and every target node that
+// no source node is mapped to get a union id, a substituted target node shares the id of its source node.
+struct PathUnionGraph {
+    std::vector<uint32_t> source_ids;
+    std::vector<uint32_t> target_ids;
+    // per union node its label in the target graph (in the source graph if the mapping deletes it) and whether the
+    // mapping deletes it (source only) or inserts it (target only)
+    std::vector<GraphStoreLabel> labels;
+    std::vector<char> deleted;
+    std::vector<char> inserted;
+    // edges of source and target graph in union ids, the target edges with their labels
+    std::set<std::pair<uint32_t, uint32_t>> edges;
+    std::map<std::pair<uint32_t, uint32_t>, GraphStoreLabel> target_edges;
+    [[nodiscard]] uint32_t size() const { return static_cast<uint32_t>(labels.size()); }
+};
+
+// Returns false if the node map does not fit the graphs (a target node used twice)
+inline bool BuildPathUnionGraph(const StoredGraph& source, const StoredGraph& target, const std::vector<MappingNode>& source_to_target, PathUnionGraph& union_graph) {
+    union_graph = PathUnionGraph{};
+    union_graph.source_ids.resize(source.nodes());
+    union_graph.target_ids.assign(target.nodes(), PATH_LAYOUT_NO_NODE);
+    for (INDEX node = 0; node < source.nodes(); ++node) {
+        const uint32_t id = union_graph.size();
+        union_graph.source_ids[node] = id;
+        union_graph.labels.push_back(source.node_labels[node]);
+        // images outside of the target graph are the dummy node
+        const bool substituted = node < source_to_target.size() && source_to_target[node] < target.nodes();
+        if (substituted) {
+            if (union_graph.target_ids[source_to_target[node]] != PATH_LAYOUT_NO_NODE) {
+                return false;
+            }
+            union_graph.target_ids[source_to_target[node]] = id;
+        }
+        union_graph.deleted.push_back(!substituted);
+        union_graph.inserted.push_back(0);
+    }
+    for (INDEX node = 0; node < target.nodes(); ++node) {
+        if (union_graph.target_ids[node] == PATH_LAYOUT_NO_NODE) {
+            union_graph.target_ids[node] = union_graph.size();
+            union_graph.labels.push_back(target.node_labels[node]);
+            union_graph.deleted.push_back(0);
+            union_graph.inserted.push_back(1);
+        }
+        else {
+            union_graph.labels[union_graph.target_ids[node]] = target.node_labels[node];
+        }
+    }
+    for (const auto& edge : source.edges) {
+        union_graph.edges.insert(std::minmax(union_graph.source_ids[edge.source], union_graph.source_ids[edge.target]));
+    }
+    for (const auto& edge : target.edges) {
+        const std::pair<uint32_t, uint32_t> key = std::minmax(union_graph.target_ids[edge.source], union_graph.target_ids[edge.target]);
+        union_graph.edges.insert(key);
+        union_graph.target_edges[key] = edge.label;
+    }
+    return true;
+}
+
+// Possible union ids of the nodes of next, from the ids of previous and the edit operation between them. A node
+// insertion appends the new node, it gets the placeholder id pending until ResolveInsertedNodes knows which target node
+// it is. A node deletion removes a node the mapping deletes, with the following ids shifted down or with the last node
+// moved into its place; every removal that reproduces next exactly is a candidate (several for symmetric graphs).
+// All other operations keep the node ids. No candidates if next does not follow from previous by the operation.
+inline std::vector<std::vector<uint32_t>> AlignStepNodes(const StoredGraph& previous, const StoredGraph& next, const EditOperation& operation,
+                                                         const std::vector<uint32_t>& previous_ids, const PathUnionGraph& union_graph, uint32_t pending) {
+    const INDEX n = previous.nodes();
+    const INDEX m = next.nodes();
+    const bool node_insertion = operation.operationObject == OperationObject::NODE && operation.type == EditType::INSERT;
+    const bool node_deletion = operation.operationObject == OperationObject::NODE && operation.type == EditType::DELETE;
+    const bool node_relabel = operation.operationObject == OperationObject::NODE && operation.type == EditType::RELABEL;
+    std::vector<std::vector<uint32_t>> candidates;
+    if (!node_deletion) {
+        if (m != (node_insertion ? n + 1 : n)) {
+            return candidates;
+        }
+        for (INDEX node = 0; node < n && !node_relabel; ++node) {
+            if (previous.node_labels[node] != next.node_labels[node]) {
+                return candidates;
+            }
+        }
+        auto& next_ids = candidates.emplace_back(previous_ids);
+        if (node_insertion) {
+            next_ids.push_back(pending);
+        }
+        return candidates;
+    }
+    if (m + 1 != n) {
+        return candidates;
+    }
+    std::map<std::pair<INDEX, INDEX>, GraphStoreLabel> next_edges;
+    for (const auto& edge : next.edges) {
+        next_edges[std::minmax(edge.source, edge.target)] = edge.label;
+    }
+    // true if removing a node from previous with the renumbering previous_to_next (-1 = removed) gives next
+    auto reproduces = [&](const std::vector<int64_t>& previous_to_next) {
+        for (INDEX node = 0; node < n; ++node) {
+            if (previous_to_next[node] >= 0 && previous.node_labels[node] != next.node_labels[previous_to_next[node]]) {
+                return false;
+            }
+        }
+        size_t kept_edges = 0;
+        for (const auto& edge : previous.edges) {
+            const int64_t a = previous_to_next[edge.source];
+            const int64_t b = previous_to_next[edge.target];
+            if (a < 0 || b < 0) {
+                continue;
+            }
+            const auto it = next_edges.find(std::minmax(static_cast<INDEX>(a), static_cast<INDEX>(b)));
+            if (it == next_edges.end() || it->second != edge.label) {
+                return false;
+            }
+            ++kept_edges;
+        }
+        return kept_edges == next_edges.size();
+    };
+    std::vector<int64_t> previous_to_next(n);
+    for (INDEX deleted = 0; deleted < n; ++deleted) {
+        if (previous_ids[deleted] >= union_graph.size() || !union_graph.deleted[previous_ids[deleted]]) {
+            continue;
+        }
+        for (int renumbering = 0; renumbering < 2; ++renumbering) {
+            for (INDEX node = 0; node < n; ++node) {
+                if (renumbering == 0) {
+                    previous_to_next[node] = node < deleted ? node : static_cast<int64_t>(node) - 1;
+                }
+                else {
+                    previous_to_next[node] = node == n - 1 ? deleted : node;
+                }
+            }
+            previous_to_next[deleted] = -1;
+            if (!reproduces(previous_to_next)) {
+                continue;
+            }
+            std::vector<uint32_t> next_ids(m, PATH_LAYOUT_NO_NODE);
+            for (INDEX node = 0; node < n; ++node) {
+                if (previous_to_next[node] >= 0) {
+                    next_ids[previous_to_next[node]] = previous_ids[node];
+                }
+            }
+            if (std::ranges::find(candidates, next_ids) == candidates.end()) {
+                candidates.push_back(std::move(next_ids));
+            }
+        }
+    }
+    return candidates;
+}
+
+// Union ids of the num_pending inserted nodes (placeholder ids first_pending, first_pending + 1, ...). The last step of a path is
+// the target graph, so the inserted nodes are assigned to the target-only union nodes such that the edges of the last
+// step are exactly the target edges (backtracking over the inserted nodes). Returns false if there is no such assignment.
+inline bool ResolveInsertedNodes(const StoredGraph& last, const std::vector<uint32_t>& last_ids, const PathUnionGraph& union_graph,
+                                 uint32_t first_pending, uint32_t num_pending, std::vector<uint32_t>& resolved) {
+    if (last.nodes() != union_graph.target_ids.size() || last.edges.size() != union_graph.target_edges.size()) {
+        return false;
+    }
+    std::vector<std::vector<std::pair<INDEX, GraphStoreLabel>>> neighbors(last.nodes());
+    for (const auto& edge : last.edges) {
+        neighbors[edge.source].emplace_back(edge.target, edge.label);
+        neighbors[edge.target].emplace_back(edge.source, edge.label);
+    }
+    std::vector<size_t> target_degree(union_graph.size(), 0);
+    for (const auto& [key, label] : union_graph.target_edges) {
+        ++target_degree[key.first];
+        ++target_degree[key.second];
+    }
+    // all edges of node to nodes with a known union id are target edges with the same label
+    std::vector<uint32_t> ids = last_ids;
+    auto fits = [&](INDEX node, uint32_t id) {
+        if (union_graph.labels[id] != last.node_labels[node] || target_degree[id] != neighbors[node].size()) {
+            return false;
+        }
+        for (const auto& [neighbor, label] : neighbors[node]) {
+            if (ids[neighbor] >= first_pending) {
+                continue;
+            }
+            const auto it = union_graph.target_edges.find(std::minmax(id, ids[neighbor]));
+            if (it == union_graph.target_edges.end() || it->second != label) {
+                return false;
+            }
+        }
+        return true;
+    };
+    std::vector<INDEX> inserted_nodes;
+    std::vector<char> used(union_graph.size(), 0);
+    for (INDEX node = 0; node < last.nodes(); ++node) {
+        if (ids[node] >= first_pending) {
+            inserted_nodes.push_back(node);
+        }
+        else if (ids[node] >= union_graph.size() || union_graph.deleted[ids[node]] || used[ids[node]]) {
+            return false;
+        }
+        else {
+            used[ids[node]] = 1;
+        }
+    }
+    if (inserted_nodes.size() != num_pending) {
+        return false;
+    }
+    for (INDEX node = 0; node < last.nodes(); ++node) {
+        if (ids[node] < first_pending && !fits(node, ids[node])) {
+            return false;
+        }
+    }
+    auto assign = [&](auto& self, size_t i) -> bool {
+        if (i == inserted_nodes.size()) {
+            return true;
+        }
+        const INDEX node = inserted_nodes[i];
+        const uint32_t placeholder = ids[node];
+        for (uint32_t id = 0; id < union_graph.size(); ++id) {
+            if (!union_graph.inserted[id] || used[id] || !fits(node, id)) {
+                continue;
+            }
+            used[id] = 1;
+            ids[node] = id;
+            if (self(self, i + 1)) {
+                return true;
+            }
+            used[id] = 0;
+            ids[node] = placeholder;
+        }
+        return false;
+    };
+    if (!assign(assign, 0)) {
+        return false;
+    }
+    resolved.assign(num_pending, PATH_LAYOUT_NO_NODE);
+    for (const INDEX node : inserted_nodes) {
+        resolved[last_ids[node] - first_pending] = ids[node];
+    }
+    return true;
+}
+
+// maximal number of step alignments AlignPathNodes tries for one path
+constexpr size_t PATH_ALIGNMENT_BUDGET = 1 << 16;
+
+// Union ids of the nodes of all steps of a path (graphs[0] is the source graph, graphs[i] follows by operations[i - 1]).
+// Depth-first over the candidates of AlignStepNodes: a branch is dropped as soon as a step has an edge that is neither a
+// source nor a target edge, and accepted once the inserted nodes resolve at the last step. Returns false if no
+// alignment is found within PATH_ALIGNMENT_BUDGET steps.
+inline bool AlignPathNodes(const std::vector<StoredGraph>& graphs, const std::vector<EditOperation>& operations, const PathUnionGraph& union_graph,
+                           std::vector<std::vector<uint32_t>>& step_nodes) {
+    const uint32_t first_pending = union_graph.size();
+    step_nodes.assign(graphs.size(), {});
+    step_nodes[0] = union_graph.source_ids;
+    size_t budget = PATH_ALIGNMENT_BUDGET;
+    auto known_edges = [&](const StoredGraph& graph, const std::vector<uint32_t>& ids) {
+        for (const auto& edge : graph.edges) {
+            if (ids[edge.source] < first_pending && ids[edge.target] < first_pending && !union_graph.edges.contains(std::minmax(ids[edge.source], ids[edge.target]))) {
+                return false;
+            }
+        }
+        return true;
+    };
+    auto align = [&](auto& self, size_t step, uint32_t num_pending) -> bool {
+        if (step == graphs.size()) {
+            std::vector<uint32_t> resolved;
+            if (!ResolveInsertedNodes(graphs.back(), step_nodes.back(), union_graph, first_pending, num_pending, resolved)) {
+                return false;
+            }
+            for (auto& nodes : step_nodes) {
+                for (uint32_t& id : nodes) {
+                    if (id >= first_pending) {
+                        id = resolved[id - first_pending];
+                    }
+                }
+            }
+            return true;
+        }
+        const EditOperation& operation = operations[step - 1];
+        const bool node_insertion = operation.operationObject == OperationObject::NODE && operation.type == EditType::INSERT;
+        for (auto& next_ids : AlignStepNodes(graphs[step - 1], graphs[step], operation, step_nodes[step - 1], union_graph, first_pending + num_pending)) {
+            if (budget == 0) {
+                return false;
+            }
+            --budget;
+            if (!known_edges(graphs[step], next_ids)) {
+                continue;
+            }
+            step_nodes[step] = std::move(next_ids);
+            if (self(self, step + 1, num_pending + node_insertion)) {
+                return true;
+            }
+        }
+        return false;
+    };
+    return graphs.front().node_labels.size() == union_graph.source_ids.size() && known_edges(graphs.front(), step_nodes[0]) && align(align, 1, 0);
+}
+
+// Fruchterman-Reingold iterations with the ideal edge length k. Only the nodes with active[node] move and repel
+// each other; the maximal displacement starts at temperature and cools down linearly.
+inline void FruchtermanReingold(std::vector<std::array<float, 2>>& positions,
+                                const std::vector<std::pair<uint32_t, uint32_t>>& edges,
+                                const std::vector<char>& active,
+                                double k,
+                                int iterations,
+                                double temperature) {
+    const size_t num_nodes = positions.size();
+    size_t active_nodes = 0;
+    for (const char is_active : active) {
+        active_nodes += is_active;
+    }
+    if (active_nodes < 2 || iterations <= 0) {
+        return;
+    }
+    std::vector<std::array<double, 2>> displacement(num_nodes);
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        std::ranges::fill(displacement, std::array<double, 2>{0.0, 0.0});
+        for (size_t u = 0; u < num_nodes; ++u) {
+            if (!active[u]) {
+                continue;
+            }
+            for (size_t v = u + 1; v < num_nodes; ++v) {
+                if (!active[v]) {
+                    continue;
+                }
+                const double dx = positions[u][0] - positions[v][0];
+                const double dy = positions[u][1] - positions[v][1];
+                const double distance_squared = std::max(dx * dx + dy * dy, 1e-9);
+                const double force = k * k / distance_squared;
+                displacement[u][0] += dx * force;
+                displacement[u][1] += dy * force;
+                displacement[v][0] -= dx * force;
+                displacement[v][1] -= dy * force;
+            }
+        }
+        for (const auto& [u, v] : edges) {
+            if (!active[u] || !active[v]) {
+                continue;
+            }
+            const double dx = positions[u][0] - positions[v][0];
+            const double dy = positions[u][1] - positions[v][1];
+            const double distance = std::sqrt(std::max(dx * dx + dy * dy, 1e-9));
+            const double force = distance / k;
+            displacement[u][0] -= dx * force;
+            displacement[u][1] -= dy * force;
+            displacement[v][0] += dx * force;
+            displacement[v][1] += dy * force;
+        }
+        const double step = temperature * (1.0 - static_cast<double>(iteration) / iterations);
+        for (size_t u = 0; u < num_nodes; ++u) {
+            if (!active[u]) {
+                continue;
+            }
+            const double length = std::sqrt(displacement[u][0] * displacement[u][0] + displacement[u][1] * displacement[u][1]);
+            if (length > 0) {
+                const double scale = std::min(length, step) / length;
+                positions[u][0] = static_cast<float>(positions[u][0] + displacement[u][0] * scale);
+                positions[u][1] = static_cast<float>(positions[u][1] + displacement[u][1] * scale);
+            }
+        }
+    }
+}
+
+// Layout of one edit path: union graph, global layout and the incrementally refined positions of every step.
+// The union graph comes from the node mapping of the pair (source_to_target) and the source and target graph of the
+// dataset; the nodes of every step are aligned to it along the edit operations of the path.
+// Returns false (and prints the reason) if a graph cannot be read or the steps do not follow the mapping.
+inline bool ComputePathLayout(const BGFIndex& path_graphs, const BGFIndex& dataset, const std::vector<MappingNode>& source_to_target,
+                              const EditPathRecord& path, int iterations, int refine_iterations, int seed, PathLayout& layout) {
+    layout.source_id = path.source_id;
+    layout.target_id = path.target_id;
+    const size_t num_steps = path.operations.size() + 1;
+
+    StoredGraph source;
+    StoredGraph target;
+    PathUnionGraph union_graph;
+    if (!dataset.ReadGraph(path.source_id, source) || !dataset.ReadGraph(path.target_id, target)) {
+        return false;
+    }
+    if (!BuildPathUnionGraph(source, target, source_to_target, union_graph)) {
+        std::cerr << "The node mapping of " << path.source_id << " -> " << path.target_id << " does not fit its graphs" << std::endl;
+        return false;
+    }
+
+    std::vector<StoredGraph> graphs(num_steps);
+    for (size_t step = 0; step < num_steps; ++step) {
+        if (!path_graphs.ReadGraph(path.first_graph + step, graphs[step])) {
+            return false;
+        }
+    }
+    if (graphs[0].node_labels != source.node_labels || graphs[0].edges.size() != source.edges.size()) {
+        std::cerr << "The first graph of the edit path " << path.source_id << " -> " << path.target_id << " is not its source graph" << std::endl;
+        return false;
+    }
+    if (!AlignPathNodes(graphs, path.operations, union_graph, layout.step_nodes)) {
+        std::cerr << "The graphs of the edit path " << path.source_id << " -> " << path.target_id << " do not follow its node mapping and edit operations" << std::endl;
+        return false;
+    }
+    layout.union_nodes = union_graph.size();
+
+    // union edges and the deltas between consecutive steps, both in union ids
+    std::set<std::pair<uint32_t, uint32_t>> union_edge_set = union_graph.edges;
+    std::vector<std::map<std::pair<uint32_t, uint32_t>, GraphStoreLabel>> step_edges(num_steps);
+    for (size_t step = 0; step < num_steps; ++step) {
+        for (const auto& edge : graphs[step].edges) {
+            const std::pair<uint32_t, uint32_t> key = std::minmax(layout.step_nodes[step][edge.source], layout.step_nodes[step][edge.target]);
+            step_edges[step][key] = edge.label;
+            union_edge_set.insert(key);
+        }
+    }
+    layout.step_deltas.resize(num_steps);
+    for (size_t step = 1; step < num_steps; ++step) {
+        auto& deltas = layout.step_deltas[step];
+        std::map<uint32_t, GraphStoreLabel> previous_nodes;
+        for (INDEX node = 0; node < graphs[step - 1].nodes(); ++node) {
+            previous_nodes[layout.step_nodes[step - 1][node]] = graphs[step - 1].node_labels[node];
+        }
+        for (INDEX node = 0; node < graphs[step].nodes(); ++node) {
+            const uint32_t id = layout.step_nodes[step][node];
+            if (const auto it = previous_nodes.find(id); it == previous_nodes.end()) {
+                deltas.push_back({PathDeltaType::NODE_INSERT, id});
+            }
+            else {
+                if (it->second != graphs[step].node_labels[node]) {
+                    deltas.push_back({PathDeltaType::NODE_RELABEL, id});
+                }
+                previous_nodes.erase(it);
+            }
+        }
+        for (const auto& [id, label] : previous_nodes) {
+            deltas.push_back({PathDeltaType::NODE_DELETE, id});
+        }
+        for (const auto& [key, label] : step_edges[step]) {
+            if (const auto it = step_edges[step - 1].find(key); it == step_edges[step - 1].end()) {
+                deltas.push_back({PathDeltaType::EDGE_INSERT, key.first, key.second});
+            }
+            else if (it->second != label) {
+                deltas.push_back({PathDeltaType::EDGE_RELABEL, key.first, key.second});
+            }
+        }
+        for (const auto& [key, label] : step_edges[step - 1]) {
+            if (!step_edges[step].contains(key)) {
+                deltas.push_back({PathDeltaType::EDGE_DELETE, key.first, key.second});
+            }
+        }
+    }
+
+    // global layout of the union graph, deterministic per pair
+    const std::vector<std::pair<uint32_t, uint32_t>> union_edges(union_edge_set.begin(), union_edge_set.end());
+    std::mt19937_64 generator(static_cast<uint64_t>(seed) ^ (static_cast<uint64_t>(path.source_id) << 32) ^ path.target_id);
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+    std::vector<std::array<float, 2>> union_positions(layout.union_nodes);
+    for (auto& position : union_positions) {
+        position = {distribution(generator), distribution(generator)};
+    }
+    double k = std::sqrt(1.0 / std::max<double>(1.0, layout.union_nodes));
+    FruchtermanReingold(union_positions, union_edges, std::vector<char>(layout.union_nodes, 1), k, iterations, 0.1);
+    // scale the union layout into the unit square, the refinement keeps the same ideal edge length relative to it
+    if (!union_positions.empty()) {
+        std::array<float, 2> min = union_positions.front();
+        std::array<float, 2> max = union_positions.front();
+        for (const auto& position : union_positions) {
+            for (int dimension = 0; dimension < 2; ++dimension) {
+                min[dimension] = std::min(min[dimension], position[dimension]);
+                max[dimension] = std::max(max[dimension], position[dimension]);
+            }
+        }
+        const double extent = std::max(max[0] - min[0], max[1] - min[1]);
+        const double scale = extent > 0 ? 1.0 / extent : 1.0;
+        for (auto& position : union_positions) {
+            position = {static_cast<float>((position[0] - min[0]) * scale), static_cast<float>((position[1] - min[1]) * scale)};
+        }
+        k *= scale;
+    }
+
+    // per step: start from the previous step (new nodes at their union position) and refine with low temperature
+    std::vector<std::array<float, 2>> positions = union_positions;
+    layout.step_positions.resize(num_steps);
+    for (size_t step = 0; step < num_steps; ++step) {
+        std::vector<char> active(layout.union_nodes, 0);
+        for (const uint32_t id : layout.step_nodes[step]) {
+            active[id] = 1;
+        }
+        for (const auto& delta : layout.step_deltas[step]) {
+            if (delta.type == PathDeltaType::NODE_INSERT) {
+                positions[delta.a] = union_positions[delta.a];
+            }
+        }
+        std::vector<std::pair<uint32_t, uint32_t>> edges;
+        edges.reserve(step_edges[step].size());
+        for (const auto& [key, label] : step_edges[step]) {
+            edges.push_back(key);
+        }
+        FruchtermanReingold(positions, edges, active, k, refine_iterations, 0.01);
+        auto& step_positions = layout.step_positions[step];
+        step_positions.reserve(layout.step_nodes[step].size());
+        for (const uint32_t id : layout.step_nodes[step]) {
+            step_positions.push_back(positions[id]);
+        }
+    }
+    return true;
+}
+
+// Layout file: magic, version, number of paths, then per path source id, target id (uint64), union nodes and steps
+// (uint32) and per step its node count and delta count (uint32), the union ids (uint32) and positions (2 x float32)
+// of its nodes and its deltas (uint8 type, 3 bytes padding, uint32 a, uint32 b).
+inline bool WritePathLayouts(const std::string& path, const std::vector<PathLayout>& layouts) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "Could not write path layouts " << path << std::endl;
+        return false;
+    }
+    auto write = [&out](const auto& value) { out.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+    write(PATH_LAYOUTS_MAGIC);
+    write(PATH_LAYOUTS_VERSION);
+    write(static_cast<uint64_t>(layouts.size()));
+    for (const auto& layout : layouts) {
+        write(static_cast<uint64_t>(layout.source_id));
+        write(static_cast<uint64_t>(layout.target_id));
+        write(layout.union_nodes);
+        write(static_cast<uint32_t>(layout.step_nodes.size()));
+        for (size_t step = 0; step < layout.step_nodes.size(); ++step) {
+            const auto& nodes = layout.step_nodes[step];
+            const auto& deltas = layout.step_deltas[step];
+            write(static_cast<uint32_t>(nodes.size()));
+            write(static_cast<uint32_t>(deltas.size()));
+            out.write(reinterpret_cast<const char*>(nodes.data()), static_cast<std::streamsize>(nodes.size() * sizeof(uint32_t)));
+            out.write(reinterpret_cast<const char*>(layout.step_positions[step].data()), static_cast<std::streamsize>(nodes.size() * 2 * sizeof(float)));
+            for (const auto& delta : deltas) {
+                const std::array<uint8_t, 4> type{static_cast<uint8_t>(delta.type), 0, 0, 0};
+                write(type);
+                write(delta.a);
+                write(delta.b);
+            }
+        }
+    }
+    return static_cast<bool>(out);
+}
+
+inline int export_path_layouts(const std::string& db,
+                               const std::string& edit_path_output,
+                               const std::string& mappings_path,
+                               const std::string& processed_graph_path,
+                               const std::string& method,
+                               const std::string& pairs_file,
+                               size_t num_paths,
+                               int iterations,
+                               int refine_iterations,
+                               int seed,
+                               int num_threads,
+                               std::string output_file) {
+    const std::string edit_path_output_db = edit_path_output + method + "/" + db + "/";
+    if (output_file.empty()) {
+        output_file = edit_path_output_db + db + "_path_layouts.bin";
+    }
+
+    ScopedPerfStage load_stage("load_paths");
+    std::vector<std::tuple<INDEX, INDEX, INDEX, EditOperation>> edit_path_info;
+    ReadEditPathInfo(edit_path_output_db + db + "_edit_paths_data.bin", edit_path_info);
+    // only the graphs of the selected paths are read from the edit path file, their source and target graphs from the dataset
+    const auto index = BGFIndex::Open(edit_path_output_db + db + "_edit_paths.bgf");
+    const auto dataset = BGFIndex::Open(processed_graph_path + db + ".bgf");
+    if (!index || !dataset) {
+        return 1;
+    }
+    const std::string mappings_db = mappings_path + method + "/" + db + "/";
+    const auto mapping_index = MappingIndex::Open(mappings_db, db);
+    if (!mapping_index) {
+        std::cerr << "ExportPathLayouts needs the mapping index " << MappingIndexFile(mappings_db, db) << ", run CreatePaths once to build it" << std::endl;
+        return 1;
+    }
+    std::vector<EditPathRecord> paths = EditPathRecords(edit_path_info);
+    if (!pairs_file.empty()) {
+        std::vector<std::pair<INDEX, INDEX>> graph_pairs;
+        if (!read_graph_pairs(pairs_file, graph_pairs)) {
+            return 1;
+        }
+        const std::set<std::pair<INDEX, INDEX>> selected(graph_pairs.begin(), graph_pairs.end());
+        std::erase_if(paths, [&selected](const EditPathRecord& path) { return !selected.contains(std::minmax(path.source_id, path.target_id)); });
+    }
+    if (num_paths > 0 && paths.size() > num_paths) {
+        paths.resize(num_paths);
+    }
+    // node map source -> target of every path
+    std::vector<std::vector<MappingNode>> node_maps(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+        const auto& path = paths[i];
+        if (path.first_graph + path.operations.size() >= index->size()) {
+            std::cerr << "Edit path " << path.source_id << " -> " << path.target_id << " exceeds the graphs of the edit path file" << std::endl;
+            return 1;
+        }
+        if (std::max(path.source_id, path.target_id) >= dataset->size()) {
+            std::cerr << "Edit path " << path.source_id << " -> " << path.target_id << " exceeds the graphs of " << dataset->path() << std::endl;
+            return 1;
+        }
+        const int64_t ordinal = mapping_index->Find(path.source_id, path.target_id);
+        if (ordinal < 0) {
+            std::cerr << "No mapping for the edit path " << path.source_id << " -> " << path.target_id << " in " << mappings_db << std::endl;
+            return 1;
+        }
+        auto node_mapping = mapping_index->NodeMapping(ordinal);
+        node_maps[i] = mapping_index->record(ordinal).source_id == path.source_id ? std::move(node_mapping.first) : std::move(node_mapping.second);
+    }
+    load_stage.Stop();
+    std::cout << "Computing layouts of " << paths.size() << " edit paths" << std::endl;
+
+    std::vector<PathLayout> layouts(paths.size());
+    std::atomic<bool> layout_failed = false;
+#pragma omp parallel num_threads(std::max(1, num_threads))
+    {
+        ScopedPerfStage layout_stage("compute_layouts", omp_get_thread_num());
+#pragma omp for schedule(dynamic)
+        for (size_t i = 0; i < paths.size(); ++i) {
+            if (!ComputePathLayout(*index, *dataset, node_maps[i], paths[i], iterations, refine_iterations, seed, layouts[i])) {
+                layout_failed = true;
+            }
+        }
+    }
+    if (layout_failed) {
+        std::cerr << "Could not compute the layouts of all selected edit paths" << std::endl;
+        return 1;
+    }
+
+    ScopedPerfStage write_stage("write_layouts");
+    if (!WritePathLayouts(output_file, layouts)) {
+        return 1;
+    }
+    std::cout << "Wrote layouts of " << layouts.size() << " edit paths to " << output_file << std::endl;
+    return 0;
+}
+
+#endif //GEDPATHS_EXPORT_PATH_LAYOUTS_H
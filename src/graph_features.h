@@ -0,0 +1,405 @@
+// Per-dataset feature sidecar (<db>_features.bin next to the preprocessed <db>.bgf) with cheap per-graph features:
+// sizes, node/edge label histograms, degree sequences, Weisfeiler-Lehman color multisets and a WL hash.
+// The features are computed once in parallel from the SharedGraphStore and stored column by column. The file records
+// the size and modification time of the .bgf file it was computed from, so tools that never load the dataset can
+// check it for free. Only if the .bgf file has changed, the graph contents are hashed and the features recomputed if
+// they differ.
+
+#ifndef GEDPATHS_GRAPH_FEATURES_H
+#define GEDPATHS_GRAPH_FEATURES_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+#include <omp.h>
+#include "src/graph_store.h"
+#include "src/mapping_store.h"
+
+struct LabelCount {
+    GraphStoreLabel label = 0;
+    uint64_t count = 0;
+};
+
+constexpr uint64_t GRAPH_FEATURES_MAGIC = 0x4552555441454647ULL; // "GFEATURE"
+constexpr uint32_t GRAPH_FEATURES_VERSION = 2;
+constexpr int GRAPH_FEATURES_WL_ITERATIONS = 3;
+
+// splitmix64 finalizer, used for all feature hashes
+inline uint64_t FeatureHash(uint64_t value) {
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+inline uint64_t FeatureHashCombine(uint64_t seed, uint64_t value) {
+    return FeatureHash(seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)));
+}
+
+// Fingerprint of the graph contents (sizes, labels and edges of all graphs), independent of file times.
+// The graphs are hashed in parallel and the graph hashes combined in id order.
+inline uint64_t GraphStoreFingerprint(const SharedGraphStore& store) {
+    std::vector<uint64_t> graph_hashes(store.size());
+#pragma omp parallel for schedule(dynamic, 64)
+    for (INDEX graph_id = 0; graph_id < store.size(); ++graph_id) {
+        uint64_t hash = FeatureHash(store.nodes(graph_id));
+        hash = FeatureHashCombine(hash, store.edges(graph_id));
+        for (const auto label : store.node_labels(graph_id)) {
+            hash = FeatureHashCombine(hash, label);
+        }
+        for (const auto& edge : store.edge_list(graph_id)) {
+            hash = FeatureHashCombine(hash, (static_cast<uint64_t>(edge.source) << 32) ^ edge.target);
+            hash = FeatureHashCombine(hash, edge.label);
+        }
+        graph_hashes[graph_id] = hash;
+    }
+    uint64_t fingerprint = FeatureHash(store.size());
+    for (const uint64_t hash : graph_hashes) {
+        fingerprint = FeatureHashCombine(fingerprint, hash);
+    }
+    return fingerprint;
+}
+
+inline std::string GraphFeatureFile(const std::string& processed_graph_path, const std::string& db) {
+    return processed_graph_path + db + "_features.bin";
+}
+
+inline std::string PreprocessedGraphFile(const std::string& processed_graph_path, const std::string& db) {
+    return processed_graph_path + db + ".bgf";
+}
+
+// Features of all graphs of a dataset. Variable-length features are stored per column in one array with offsets per graph.
+class GraphFeatures {
+public:
+    GraphFeatures() = default;
+    // Compute the features of all graphs of the store in parallel
+    static GraphFeatures Compute(const SharedGraphStore& store, int wl_iterations = GRAPH_FEATURES_WL_ITERATIONS);
+    // Load the sidecar of the dataset if it matches the store, otherwise compute and write it. The graphs are only
+    // hashed if the .bgf file has changed since the sidecar was written.
+    static GraphFeatures LoadOrCompute(const std::string& processed_graph_path, const std::string& db, const SharedGraphStore& store);
+    // Load the sidecar without the graphs (CreatePaths, AnalyzeMappings), returns false if there is none or the .bgf
+    // file has changed since it was written
+    static bool Load(const std::string& processed_graph_path, const std::string& db, GraphFeatures& features);
+    bool Write(const std::string& path) const;
+    // Returns false if the file does not exist or is broken
+    static bool Read(const std::string& path, GraphFeatures& features);
+
+    [[nodiscard]] INDEX size() const { return _nodes.size(); }
+    [[nodiscard]] int wl_iterations() const { return _wl_iterations; }
+    [[nodiscard]] uint64_t fingerprint() const { return _fingerprint; }
+    [[nodiscard]] uint32_t nodes(INDEX graph_id) const { return _nodes[graph_id]; }
+    [[nodiscard]] uint32_t edges(INDEX graph_id) const { return _edges[graph_id]; }
+    // Hash of the final WL color multiset, equal for isomorphic graphs (different graphs may collide)
+    [[nodiscard]] uint64_t wl_hash(INDEX graph_id) const { return _wl_hashes[graph_id]; }
+    // (label, count) sorted by label
+    [[nodiscard]] std::span<const LabelCount> node_label_histogram(INDEX graph_id) const;
+    [[nodiscard]] std::span<const LabelCount> edge_label_histogram(INDEX graph_id) const;
+    // node degrees in descending order
+    [[nodiscard]] std::span<const uint32_t> degree_sequence(INDEX graph_id) const;
+    // sorted node colors after the given WL iteration (0 are the node labels)
+    [[nodiscard]] std::span<const uint64_t> wl_colors(INDEX graph_id, int iteration) const;
+
+    // Size of the intersection of the node (edge) label multisets of two graphs
+    [[nodiscard]] uint64_t NodeLabelOverlap(INDEX a, INDEX b) const { return HistogramOverlap(node_label_histogram(a), node_label_histogram(b)); }
+    [[nodiscard]] uint64_t EdgeLabelOverlap(INDEX a, INDEX b) const { return HistogramOverlap(edge_label_histogram(a), edge_label_histogram(b)); }
+    // Groups of graph ids with equal WL hash (candidates for duplicates), only groups with at least two graphs
+    [[nodiscard]] std::vector<std::vector<INDEX>> DuplicateCandidates() const;
+    void Print() const;
+
+private:
+    static uint64_t HistogramOverlap(std::span<const LabelCount> a, std::span<const LabelCount> b);
+
+    // .bgf file the features belong to and the fingerprint of its graph contents
+    MappingFileFingerprint _graph_file;
+    uint64_t _fingerprint = 0;
+    int _wl_iterations = 0;
+    std::vector<uint32_t> _nodes;
+    std::vector<uint32_t> _edges;
+    std::vector<uint64_t> _wl_hashes;
+    std::vector<uint64_t> _node_label_offsets{0};
+    std::vector<LabelCount> _node_label_counts;
+    std::vector<uint64_t> _edge_label_offsets{0};
+    std::vector<LabelCount> _edge_label_counts;
+    // degrees and WL colors have one entry per node, graph i starts at _node_offsets[i] (times the iterations + 1)
+    std::vector<uint64_t> _node_offsets{0};
+    std::vector<uint32_t> _degrees;
+    std::vector<uint64_t> _wl_colors;
+};
+
+inline std::span<const LabelCount> GraphFeatures::node_label_histogram(INDEX graph_id) const {
+    return {_node_label_counts.data() + _node_label_offsets[graph_id], _node_label_offsets[graph_id + 1] - _node_label_offsets[graph_id]};
+}
+
+inline std::span<const LabelCount> GraphFeatures::edge_label_histogram(INDEX graph_id) const {
+    return {_edge_label_counts.data() + _edge_label_offsets[graph_id], _edge_label_offsets[graph_id + 1] - _edge_label_offsets[graph_id]};
+}
+
+inline std::span<const uint32_t> GraphFeatures::degree_sequence(INDEX graph_id) const {
+    return {_degrees.data() + _node_offsets[graph_id], _nodes[graph_id]};
+}
+
+inline std::span<const uint64_t> GraphFeatures::wl_colors(INDEX graph_id, int iteration) const {
+    const size_t begin = _node_offsets[graph_id] * (_wl_iterations + 1) + static_cast<size_t>(iteration) * _nodes[graph_id];
+    return {_wl_colors.data() + begin, _nodes[graph_id]};
+}
+
+inline uint64_t GraphFeatures::HistogramOverlap(std::span<const LabelCount> a, std::span<const LabelCount> b) {
+    uint64_t overlap = 0;
+    auto it_a = a.begin();
+    auto it_b = b.begin();
+    while (it_a != a.end() && it_b != b.end()) {
+        if (it_a->label < it_b->label) {
+            ++it_a;
+        }
+        else if (it_b->label < it_a->label) {
+            ++it_b;
+        }
+        else {
+            overlap += std::min(it_a->count, it_b->count);
+            ++it_a;
+            ++it_b;
+        }
+    }
+    return overlap;
+}
+
+inline GraphFeatures GraphFeatures::Compute(const SharedGraphStore &store, int wl_iterations) {
+    GraphFeatures features;
+    features._fingerprint = GraphStoreFingerprint(store);
+    features._wl_iterations = wl_iterations;
+    const INDEX num_graphs = store.size();
+    features._nodes.resize(num_graphs);
+    features._edges.resize(num_graphs);
+    features._wl_hashes.resize(num_graphs);
+    features._node_offsets.resize(num_graphs + 1);
+    for (INDEX graph_id = 0; graph_id < num_graphs; ++graph_id) {
+        features._nodes[graph_id] = store.nodes(graph_id);
+        features._edges[graph_id] = store.edges(graph_id);
+        features._node_offsets[graph_id + 1] = features._node_offsets[graph_id] + store.nodes(graph_id);
+    }
+    // fixed-size columns are filled in place, the histograms are collected per graph and concatenated afterwards
+    features._degrees.resize(features._node_offsets.back());
+    features._wl_colors.resize(features._node_offsets.back() * (wl_iterations + 1));
+    std::vector<std::vector<LabelCount>> node_histograms(num_graphs);
+    std::vector<std::vector<LabelCount>> edge_histograms(num_graphs);
+
+    auto histogram = [](std::vector<GraphStoreLabel>& labels) {
+        std::ranges::sort(labels);
+        std::vector<LabelCount> counts;
+        for (const auto label : labels) {
+            if (counts.empty() || counts.back().label != label) {
+                counts.push_back({label, 0});
+            }
+            ++counts.back().count;
+        }
+        return counts;
+    };
+
+#pragma omp parallel for schedule(dynamic, 64)
+    for (INDEX graph_id = 0; graph_id < num_graphs; ++graph_id) {
+        const INDEX nodes = store.nodes(graph_id);
+        const auto node_labels = store.node_labels(graph_id);
+        const auto edge_list = store.edge_list(graph_id);
+        std::vector<GraphStoreLabel> labels(node_labels.begin(), node_labels.end());
+        node_histograms[graph_id] = histogram(labels);
+        labels.clear();
+        for (const auto& edge : edge_list) {
+            labels.push_back(edge.label);
+        }
+        edge_histograms[graph_id] = histogram(labels);
+
+        // labeled adjacency of this graph, the store only keeps the labels in the edge list
+        std::vector<std::vector<std::pair<INDEX, GraphStoreLabel>>> adjacency(nodes);
+        for (const auto& edge : edge_list) {
+            adjacency[edge.source].emplace_back(edge.target, edge.label);
+            adjacency[edge.target].emplace_back(edge.source, edge.label);
+        }
+        uint32_t* degrees = features._degrees.data() + features._node_offsets[graph_id];
+        for (INDEX node = 0; node < nodes; ++node) {
+            degrees[node] = adjacency[node].size();
+        }
+        std::sort(degrees, degrees + nodes, std::greater<>());
+
+        // WL refinement: the new color of a node hashes its color with the sorted (neighbor color, edge label) pairs
+        std::vector<uint64_t> colors(nodes);
+        std::vector<uint64_t> next_colors(nodes);
+        std::vector<uint64_t> neighborhood;
+        uint64_t* sorted_colors = features._wl_colors.data() + features._node_offsets[graph_id] * (wl_iterations + 1);
+        for (INDEX node = 0; node < nodes; ++node) {
+            colors[node] = FeatureHash(node_labels[node]);
+        }
+        for (int iteration = 0; iteration <= wl_iterations; ++iteration) {
+            if (iteration > 0) {
+                for (INDEX node = 0; node < nodes; ++node) {
+                    neighborhood.clear();
+                    for (const auto& [neighbor, label] : adjacency[node]) {
+                        neighborhood.push_back(FeatureHashCombine(colors[neighbor], label));
+                    }
+                    std::ranges::sort(neighborhood);
+                    uint64_t color = colors[node];
+                    for (const auto value : neighborhood) {
+                        color = FeatureHashCombine(color, value);
+                    }
+                    next_colors[node] = color;
+                }
+                std::swap(colors, next_colors);
+            }
+            uint64_t* iteration_colors = sorted_colors + static_cast<size_t>(iteration) * nodes;
+            std::ranges::copy(colors, iteration_colors);
+            std::sort(iteration_colors, iteration_colors + nodes);
+        }
+        uint64_t hash = FeatureHashCombine(FeatureHash(nodes), edge_list.size());
+        for (INDEX i = 0; i < nodes; ++i) {
+            hash = FeatureHashCombine(hash, sorted_colors[static_cast<size_t>(wl_iterations) * nodes + i]);
+        }
+        features._wl_hashes[graph_id] = hash;
+    }
+
+    for (INDEX graph_id = 0; graph_id < num_graphs; ++graph_id) {
+        features._node_label_counts.insert(features._node_label_counts.end(), node_histograms[graph_id].begin(), node_histograms[graph_id].end());
+        features._node_label_offsets.push_back(features._node_label_counts.size());
+        features._edge_label_counts.insert(features._edge_label_counts.end(), edge_histograms[graph_id].begin(), edge_histograms[graph_id].end());
+        features._edge_label_offsets.push_back(features._edge_label_counts.size());
+    }
+    return features;
+}
+
+inline bool GraphFeatures::Write(const std::string &path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "Could not write graph features " << path << std::endl;
+        return false;
+    }
+    auto write = [&out](const auto& value) { out.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+    auto write_column = [&](const auto& column) {
+        write(static_cast<uint64_t>(column.size()));
+        out.write(reinterpret_cast<const char*>(column.data()), static_cast<std::streamsize>(column.size() * sizeof(column[0])));
+    };
+    write(GRAPH_FEATURES_MAGIC);
+    write(GRAPH_FEATURES_VERSION);
+    write(_graph_file.size);
+    write(_graph_file.modified);
+    write(_fingerprint);
+    write(static_cast<int32_t>(_wl_iterations));
+    write_column(_nodes);
+    write_column(_edges);
+    write_column(_wl_hashes);
+    write_column(_node_label_offsets);
+    write_column(_node_label_counts);
+    write_column(_edge_label_offsets);
+    write_column(_edge_label_counts);
+    write_column(_node_offsets);
+    write_column(_degrees);
+    write_column(_wl_colors);
+    return static_cast<bool>(out);
+}
+
+inline bool GraphFeatures::Read(const std::string &path, GraphFeatures &features) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        return false;
+    }
+    auto read = [&in](auto& value) { in.read(reinterpret_cast<char*>(&value), sizeof(value)); };
+    auto read_column = [&](auto& column, uint64_t expected_size) {
+        uint64_t size = 0;
+        read(size);
+        if (!in || size != expected_size) {
+            return false;
+        }
+        column.resize(size);
+        in.read(reinterpret_cast<char*>(column.data()), static_cast<std::streamsize>(size * sizeof(column[0])));
+        return static_cast<bool>(in);
+    };
+    uint64_t magic = 0;
+    uint32_t version = 0;
+    int32_t wl_iterations = 0;
+    read(magic);
+    read(version);
+    read(features._graph_file.size);
+    read(features._graph_file.modified);
+    read(features._fingerprint);
+    read(wl_iterations);
+    if (!in || magic != GRAPH_FEATURES_MAGIC || version != GRAPH_FEATURES_VERSION || wl_iterations < 0) {
+        return false;
+    }
+    features._wl_iterations = wl_iterations;
+    // the sizes of the later columns follow from the earlier ones, which guards against truncated files
+    uint64_t num_graphs = 0;
+    const auto start = in.tellg();
+    read(num_graphs);
+    in.seekg(start);
+    if (!read_column(features._nodes, num_graphs) || !read_column(features._edges, num_graphs) || !read_column(features._wl_hashes, num_graphs)
+        || !read_column(features._node_label_offsets, num_graphs + 1)
+        || !read_column(features._node_label_counts, features._node_label_offsets.back())
+        || !read_column(features._edge_label_offsets, num_graphs + 1)
+        || !read_column(features._edge_label_counts, features._edge_label_offsets.back())
+        || !read_column(features._node_offsets, num_graphs + 1)
+        || !read_column(features._degrees, features._node_offsets.back())
+        || !read_column(features._wl_colors, features._node_offsets.back() * (wl_iterations + 1))) {
+        return false;
+    }
+    return true;
+}
+
+inline GraphFeatures GraphFeatures::LoadOrCompute(const std::string &processed_graph_path, const std::string &db, const SharedGraphStore &store) {
+    const std::string path = GraphFeatureFile(processed_graph_path, db);
+    const MappingFileFingerprint graph_file = MappingFileFingerprint::Of(PreprocessedGraphFile(processed_graph_path, db));
+    GraphFeatures features;
+    if (Read(path, features)) {
+        if (features._graph_file == graph_file && graph_file.size > 0) {
+            return features;
+        }
+        // the .bgf file was rewritten (e.g. preprocessed again), the features are still valid if the contents are equal
+        if (features._fingerprint == GraphStoreFingerprint(store)) {
+            features._graph_file = graph_file;
+            features.Write(path);
+            return features;
+        }
+    }
+    std::cout << "Computing graph features of " << db << std::endl;
+    features = Compute(store);
+    features._graph_file = graph_file;
+    features.Write(path);
+    return features;
+}
+
+inline bool GraphFeatures::Load(const std::string &processed_graph_path, const std::string &db, GraphFeatures &features) {
+    const MappingFileFingerprint graph_file = MappingFileFingerprint::Of(PreprocessedGraphFile(processed_graph_path, db));
+    return graph_file.size > 0 && Read(GraphFeatureFile(processed_graph_path, db), features) && features._graph_file == graph_file;
+}
+
+inline std::vector<std::vector<INDEX>> GraphFeatures::DuplicateCandidates() const {
+    std::vector<INDEX> order(size());
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::stable_sort(order, [this](INDEX a, INDEX b) { return _wl_hashes[a] < _wl_hashes[b]; });
+    std::vector<std::vector<INDEX>> groups;
+    for (size_t begin = 0; begin < order.size();) {
+        size_t end = begin + 1;
+        while (end < order.size() && _wl_hashes[order[end]] == _wl_hashes[order[begin]]) {
+            ++end;
+        }
+        if (end - begin > 1) {
+            groups.emplace_back(order.begin() + begin, order.begin() + end);
+        }
+        begin = end;
+    }
+    return groups;
+}
+
+inline void GraphFeatures::Print() const {
+    size_t duplicates = 0;
+    for (const auto& group : DuplicateCandidates()) {
+        duplicates += group.size() - 1;
+    }
+    std::cout << "Graph features: " << size() << " graphs, " << _node_offsets.back() << " nodes, "
+              << _wl_iterations << " WL iterations, " << duplicates << " graphs with the WL hash of an earlier graph" << std::endl;
+}
+
+#endif //GEDPATHS_GRAPH_FEATURES_H
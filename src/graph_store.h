@@ -0,0 +1,226 @@
+// Immutable, flat graph store that is shared read-only between several GED environments
+// (per-thread workers, repair runs) instead of every environment holding its own copy of the dataset.
+// The store is an additional copy next to the GraphData<UDataGraph> (which libGraph still needs for the results,
+// the merge of the tmp files and the repairs). It pays off as soon as more than one environment is built from it;
+// a run with a single environment over all pairs holds the dataset once more than before.
+
+#ifndef GEDPATHS_GRAPH_STORE_H
+#define GEDPATHS_GRAPH_STORE_H
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+#include <libGraph.h>
+#include "src/graph_store_types.h"
+
+// Node labels, edge lists and adjacency of all graphs of a dataset in a few contiguous arrays (CSR layout).
+// The store is never modified after construction, hence it can be shared between threads via SharedGraphStorePtr.
+class SharedGraphStore {
+public:
+    SharedGraphStore() = default;
+    explicit SharedGraphStore(const GraphData<UDataGraph>& graphs);
+
+    [[nodiscard]] INDEX size() const { return _names.size(); }
+    [[nodiscard]] INDEX nodes(INDEX graph_id) const { return _node_offsets[graph_id + 1] - _node_offsets[graph_id]; }
+    [[nodiscard]] INDEX edges(INDEX graph_id) const { return _edge_offsets[graph_id + 1] - _edge_offsets[graph_id]; }
+    [[nodiscard]] const std::string& name(INDEX graph_id) const { return _names[graph_id]; }
+    [[nodiscard]] std::span<const GraphStoreLabel> node_labels(INDEX graph_id) const;
+    [[nodiscard]] std::span<const GraphStoreEdge> edge_list(INDEX graph_id) const;
+    [[nodiscard]] std::span<const INDEX> neighbors(INDEX graph_id, INDEX node) const;
+    // Approximate number of bytes held by the store (used for the memory report)
+    [[nodiscard]] size_t MemoryBytes() const;
+
+private:
+    // label accessors of the libGraph graphs, kept in one place
+    static GraphStoreLabel NodeLabel(const UDataGraph& graph, INDEX node);
+    static GraphStoreLabel EdgeLabel(const UDataGraph& graph, INDEX source, INDEX target);
+
+    std::vector<std::string> _names;
+    // _node_offsets[i].._node_offsets[i+1] are the nodes of graph i in _node_labels and _adjacency_offsets
+    std::vector<size_t> _node_offsets{0};
+    std::vector<GraphStoreLabel> _node_labels;
+    // _edge_offsets[i].._edge_offsets[i+1] are the edges of graph i (each undirected edge stored once with source < target)
+    std::vector<size_t> _edge_offsets{0};
+    std::vector<GraphStoreEdge> _edges;
+    // per (global) node the range of its neighbors in _adjacency
+    std::vector<size_t> _adjacency_offsets{0};
+    std::vector<INDEX> _adjacency;
+};
+
+using SharedGraphStorePtr = std::shared_ptr<const SharedGraphStore>;
+
+inline GraphStoreLabel SharedGraphStore::NodeLabel(const UDataGraph &graph, INDEX node) {
+    return static_cast<GraphStoreLabel>(graph.label(node));
+}
+
+inline GraphStoreLabel SharedGraphStore::EdgeLabel(const UDataGraph &graph, INDEX source, INDEX target) {
+    return static_cast<GraphStoreLabel>(graph.GetEdgeLabel(source, target));
+}
+
+inline SharedGraphStore::SharedGraphStore(const GraphData<UDataGraph> &graphs) {
+    size_t total_nodes = 0;
+    size_t total_edges = 0;
+    for (const auto& graph : graphs.graphData) {
+        total_nodes += graph.nodes();
+        total_edges += graph.edges();
+    }
+    _names.reserve(graphs.graphData.size());
+    _node_offsets.reserve(graphs.graphData.size() + 1);
+    _edge_offsets.reserve(graphs.graphData.size() + 1);
+    _node_labels.reserve(total_nodes);
+    _adjacency_offsets.reserve(total_nodes + 1);
+    _adjacency.reserve(2 * total_edges);
+    _edges.reserve(total_edges);
+
+    for (const auto& graph : graphs.graphData) {
+        _names.emplace_back(graph.GetName());
+        for (INDEX node = 0; node < graph.nodes(); ++node) {
+            _node_labels.push_back(NodeLabel(graph, node));
+            for (const auto neighbor : graph.get_neighbors(node)) {
+                _adjacency.push_back(neighbor);
+                if (node < neighbor) {
+                    _edges.push_back({node, static_cast<INDEX>(neighbor), EdgeLabel(graph, node, neighbor)});
+                }
+            }
+            _adjacency_offsets.push_back(_adjacency.size());
+        }
+        _node_offsets.push_back(_node_labels.size());
+        _edge_offsets.push_back(_edges.size());
+    }
+}
+
+inline std::span<const GraphStoreLabel> SharedGraphStore::node_labels(INDEX graph_id) const {
+    return {_node_labels.data() + _node_offsets[graph_id], nodes(graph_id)};
+}
+
+inline std::span<const GraphStoreEdge> SharedGraphStore::edge_list(INDEX graph_id) const {
+    return {_edges.data() + _edge_offsets[graph_id], edges(graph_id)};
+}
+
+inline std::span<const INDEX> SharedGraphStore::neighbors(INDEX graph_id, INDEX node) const {
+    const size_t global_node = _node_offsets[graph_id] + node;
+    const size_t begin = _adjacency_offsets[global_node];
+    return {_adjacency.data() + begin, _adjacency_offsets[global_node + 1] - begin};
+}
+
+inline size_t SharedGraphStore::MemoryBytes() const {
+    size_t bytes = _node_offsets.capacity() * sizeof(size_t)
+                 + _node_labels.capacity() * sizeof(GraphStoreLabel)
+                 + _edge_offsets.capacity() * sizeof(size_t)
+                 + _edges.capacity() * sizeof(GraphStoreEdge)
+                 + _adjacency_offsets.capacity() * sizeof(size_t)
+                 + _adjacency.capacity() * sizeof(INDEX);
+    for (const auto& name : _names) {
+        bytes += sizeof(std::string) + name.capacity();
+    }
+    return bytes;
+}
+
+// libGraph graph of one graph of a store (primary node and edge label as the only features), for the results of
+// modes that never load the dataset as GraphData. Works with every store that offers name(), node_labels() and edge_list().
+template <typename Store>
+inline UDataGraph StoreGraphToUDataGraph(const Store& store, INDEX graph_id) {
+    UDataGraph graph;
+    graph.SetName(std::string(store.name(graph_id)));
+    const auto labels = store.node_labels(graph_id);
+    std::vector<std::vector<double>> node_features(labels.size());
+    for (INDEX node = 0; node < labels.size(); ++node) {
+        node_features[node] = {static_cast<double>(labels[node])};
+    }
+    graph.AddNodes(labels.size(), node_features);
+    for (const auto& edge : store.edge_list(graph_id)) {
+        graph.AddEdge(edge.source, edge.target, {static_cast<double>(edge.label)}, false);
+    }
+    return graph;
+}
+
+// Two graphs of a store seen as a store with ids 0 and 1, used to set up a GED environment for a single pair
+// without empty placeholders for all other graphs of the store
+template <typename Store>
+class StorePairView {
+public:
+    StorePairView(const Store& store, INDEX source_id, INDEX target_id) : _store(store), _graph_ids{source_id, target_id} {}
+    [[nodiscard]] INDEX size() const { return 2; }
+    [[nodiscard]] INDEX nodes(INDEX graph_id) const { return _store.nodes(_graph_ids[graph_id]); }
+    [[nodiscard]] const std::string& name(INDEX graph_id) const { return _store.name(_graph_ids[graph_id]); }
+    [[nodiscard]] std::span<const GraphStoreLabel> node_labels(INDEX graph_id) const { return _store.node_labels(_graph_ids[graph_id]); }
+    [[nodiscard]] std::span<const GraphStoreEdge> edge_list(INDEX graph_id) const { return _store.edge_list(_graph_ids[graph_id]); }
+private:
+    const Store& _store;
+    std::array<INDEX, 2> _graph_ids;
+};
+
+// Collect the sorted, unique graph ids that occur in the given pairs
+inline std::vector<INDEX> ReferencedGraphIds(const std::vector<std::pair<INDEX, INDEX>>& graph_pairs, size_t max_pairs = std::numeric_limits<size_t>::max()) {
+    std::vector<INDEX> graph_ids;
+    const size_t num_pairs = std::min(max_pairs, graph_pairs.size());
+    graph_ids.reserve(2 * num_pairs);
+    for (size_t i = 0; i < num_pairs; ++i) {
+        graph_ids.push_back(graph_pairs[i].first);
+        graph_ids.push_back(graph_pairs[i].second);
+    }
+    std::ranges::sort(graph_ids);
+    graph_ids.erase(std::unique(graph_ids.begin(), graph_ids.end()), graph_ids.end());
+    return graph_ids;
+}
+
+#ifdef GEDLIB
+#include <src/env/ged_env.hpp>
+
+// True if init_method of the method runs over all graphs of the environment: the ML-based methods train on all
+// graph pairs (unless a trained model is loaded with --load), also as initialization of the local search methods.
+// Empty placeholder graphs would become part of their training data.
+inline bool InitializesOnAllGraphs(ged::Options::GEDMethod ged_method, const std::string& method_options) {
+    if (method_options.find("--load ") != std::string::npos) {
+        return false;
+    }
+    if (ged_method == ged::Options::GEDMethod::RING_ML || ged_method == ged::Options::GEDMethod::BIPARTITE_ML) {
+        return true;
+    }
+    for (const std::string method : {"RING_ML", "BIPARTITE_ML"}) {
+        if (method_options.find("--initialization-method " + method) != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Populate a GED environment from a shared store instead of copying the whole GraphData.
+// Only the graphs in graph_ids (sorted, empty = all) get their nodes and edges, all others are added as empty
+// placeholders so that the environment graph ids stay equal to the dataset ids (ComputeGEDResult relies on that).
+// GEDLIB handles graphs without nodes in init() and in the per-pair methods, but methods that initialize on all
+// graphs (InitializesOnAllGraphs) always get the complete store.
+// Works with every store that offers size(), name(), node_labels() and edge_list().
+template <typename Store>
+inline void InitializeGEDEnvironmentFromStore(ged::GEDEnv<ged::LabelID, ged::LabelID, ged::LabelID>& ged_env,
+                                              const Store& store,
+                                              const std::vector<INDEX>& graph_ids,
+                                              ged::Options::EditCosts edit_cost,
+                                              ged::Options::GEDMethod ged_method,
+                                              const std::string& method_options = "") {
+    const bool all_graphs = graph_ids.empty() || InitializesOnAllGraphs(ged_method, method_options);
+    for (INDEX graph_id = 0; graph_id < store.size(); ++graph_id) {
+        const ged::GEDGraph::GraphID env_id = ged_env.add_graph(std::string(store.name(graph_id)));
+        if (!all_graphs && !std::ranges::binary_search(graph_ids, graph_id)) {
+            continue;
+        }
+        const auto labels = store.node_labels(graph_id);
+        for (INDEX node = 0; node < labels.size(); ++node) {
+            ged_env.add_node(env_id, node, labels[node]);
+        }
+        for (const auto& edge : store.edge_list(graph_id)) {
+            ged_env.add_edge(env_id, edge.source, edge.target, edge.label);
+        }
+    }
+    ged_env.set_edit_costs(edit_cost);
+    ged_env.init(ged::Options::InitType::EAGER_WITHOUT_SHUFFLED_COPIES);
+    ged_env.set_method(ged_method, method_options);
+    ged_env.init_method();
+}
+#endif
+
+#endif //GEDPATHS_GRAPH_STORE_H
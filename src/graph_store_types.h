@@ -0,0 +1,18 @@
+// Label and edge types shared by the in-memory graph store (graph_store.h) and the .bgf index (bgf_index.h)
+
+#ifndef GEDPATHS_GRAPH_STORE_TYPES_H
+#define GEDPATHS_GRAPH_STORE_TYPES_H
+
+#include <cstddef>
+#include <libGraph.h>
+
+// same label type as ged::LabelID so the store can be handed to GEDLIB without conversion
+using GraphStoreLabel = std::size_t;
+
+struct GraphStoreEdge {
+    INDEX source = 0;
+    INDEX target = 0;
+    GraphStoreLabel label = 0;
+};
+
+#endif //GEDPATHS_GRAPH_STORE_TYPES_H
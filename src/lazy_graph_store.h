@@ -0,0 +1,121 @@
+// Out-of-core access to .bgf graph files: a disk-backed graph store on top of the offset index (bgf_index.h)
+// that loads single graphs by id on demand through a bounded LRU cache.
+// Used for datasets (and edit path files) that do not fit into memory as a whole GraphData<UDataGraph>.
+
+#ifndef GEDPATHS_LAZY_GRAPH_STORE_H
+#define GEDPATHS_LAZY_GRAPH_STORE_H
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "src/bgf_index.h"
+#include "src/graph_store.h"
+
+// Disk-backed graph store: graphs are read by id on demand and kept in an LRU cache of at most cache_capacity graphs
+class LazyGraphStore {
+public:
+    LazyGraphStore(std::unique_ptr<BGFIndex> index, size_t cache_capacity);
+    static std::unique_ptr<LazyGraphStore> Open(const std::string& path, size_t cache_capacity);
+
+    [[nodiscard]] INDEX size() const { return _index->size(); }
+    [[nodiscard]] INDEX nodes(INDEX graph_id) const { return _index->entry(graph_id).nodes; }
+    [[nodiscard]] INDEX edges(INDEX graph_id) const { return _index->entry(graph_id).edges; }
+    [[nodiscard]] size_t cache_capacity() const { return _cache_capacity; }
+    // Graph from the cache or from disk (thread-safe), nullptr if it cannot be read
+    std::shared_ptr<const StoredGraph> Get(INDEX graph_id);
+    void PrintCacheStatistics() const;
+private:
+    using LRUList = std::list<std::pair<INDEX, std::shared_ptr<const StoredGraph>>>;
+    std::unique_ptr<BGFIndex> _index;
+    size_t _cache_capacity;
+    mutable std::mutex _mutex;
+    // most recently used graph at the front
+    LRUList _lru;
+    std::unordered_map<INDEX, LRUList::iterator> _cache;
+    size_t _hits = 0;
+    size_t _misses = 0;
+};
+
+inline LazyGraphStore::LazyGraphStore(std::unique_ptr<BGFIndex> index, size_t cache_capacity)
+    : _index(std::move(index)), _cache_capacity(std::max<size_t>(cache_capacity, 2)) {
+}
+
+inline std::unique_ptr<LazyGraphStore> LazyGraphStore::Open(const std::string &path, size_t cache_capacity) {
+    auto index = BGFIndex::Open(path);
+    if (!index) {
+        return nullptr;
+    }
+    return std::make_unique<LazyGraphStore>(std::move(index), cache_capacity);
+}
+
+inline std::shared_ptr<const StoredGraph> LazyGraphStore::Get(INDEX graph_id) {
+    {
+        std::lock_guard lock(_mutex);
+        if (const auto it = _cache.find(graph_id); it != _cache.end()) {
+            _lru.splice(_lru.begin(), _lru, it->second);
+            ++_hits;
+            return it->second->second;
+        }
+        ++_misses;
+    }
+    // read outside of the lock, several threads may load different graphs at the same time
+    auto read_graph = std::make_shared<StoredGraph>();
+    if (!_index->ReadGraph(graph_id, *read_graph)) {
+        return nullptr;
+    }
+    std::shared_ptr<const StoredGraph> graph = std::move(read_graph);
+    std::lock_guard lock(_mutex);
+    if (const auto it = _cache.find(graph_id); it != _cache.end()) {
+        return it->second->second;
+    }
+    _lru.emplace_front(graph_id, graph);
+    _cache[graph_id] = _lru.begin();
+    while (_lru.size() > _cache_capacity) {
+        _cache.erase(_lru.back().first);
+        _lru.pop_back();
+    }
+    return graph;
+}
+
+inline void LazyGraphStore::PrintCacheStatistics() const {
+    std::lock_guard lock(_mutex);
+    const size_t requests = _hits + _misses;
+    std::cout << "Graph cache: " << _hits << " hits, " << _misses << " misses";
+    if (requests > 0) {
+        std::cout << " (hit rate " << 100.0 * static_cast<double>(_hits) / static_cast<double>(requests) << "%)";
+    }
+    std::cout << ", capacity " << _cache_capacity << " graphs" << std::endl;
+}
+
+// Two graphs of a pair seen as a store with ids 0 and 1, used to set up a GED environment for a single pair
+class GraphPairView {
+public:
+    GraphPairView(const StoredGraph& source, const StoredGraph& target) : _graphs{&source, &target} {}
+    [[nodiscard]] INDEX size() const { return 2; }
+    [[nodiscard]] INDEX nodes(INDEX graph_id) const { return _graphs[graph_id]->nodes(); }
+    [[nodiscard]] const std::string& name(INDEX graph_id) const { return _graphs[graph_id]->name; }
+    [[nodiscard]] std::span<const GraphStoreLabel> node_labels(INDEX graph_id) const { return _graphs[graph_id]->node_labels; }
+    [[nodiscard]] std::span<const GraphStoreEdge> edge_list(INDEX graph_id) const { return _graphs[graph_id]->edges; }
+private:
+    std::array<const StoredGraph*, 2> _graphs;
+};
+
+// Order the pairs such that consecutive pairs reuse cached graphs: the pair matrix is cut into square tiles of
+// cache_capacity / 2 graph ids per side, all pairs of one tile touch at most cache_capacity different graphs.
+inline void OrderPairsForCache(std::vector<std::pair<INDEX, INDEX>>& graph_pairs, size_t cache_capacity) {
+    const INDEX tile = std::max<size_t>(cache_capacity / 2, 1);
+    std::ranges::sort(graph_pairs, [tile](const std::pair<INDEX, INDEX>& a, const std::pair<INDEX, INDEX>& b) {
+        const auto tile_a = std::make_pair(a.first / tile, a.second / tile);
+        const auto tile_b = std::make_pair(b.first / tile, b.second / tile);
+        return tile_a != tile_b ? tile_a < tile_b : a < b;
+    });
+}
+
+#endif //GEDPATHS_LAZY_GRAPH_STORE_H
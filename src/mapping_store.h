@@ -0,0 +1,677 @@
+// Metadata of a mapping store (<db>_ged_mapping.bin): mergeable summary accumulators of all stored mappings and
+// secondary indexes (by graph id, distance, gap and validity) over fixed-size records of the mappings.
+// Both are rewritten whenever the mappings are written, so summary queries (count, mean, stddev, min, max,
+// distance and gap histograms, validity counts) and selections of mappings do not need to load and scan the mappings.
+
+#ifndef GEDPATHS_MAPPING_STORE_H
+#define GEDPATHS_MAPPING_STORE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <omp.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <libGraph.h>
+
+// Welford accumulator (mean and sum of squared deviations) with min/max. Two accumulators merge exactly (Chan et al.).
+struct MomentAccumulator {
+    uint64_t n = 0;
+    double mean = 0.0;
+    double m2 = 0.0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+
+    void Add(double value) {
+        ++n;
+        const double delta = value - mean;
+        mean += delta / static_cast<double>(n);
+        m2 += delta * (value - mean);
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+    void Merge(const MomentAccumulator& other) {
+        if (other.n == 0) {
+            return;
+        }
+        const double total = static_cast<double>(n + other.n);
+        const double delta = other.mean - mean;
+        mean += delta * static_cast<double>(other.n) / total;
+        m2 += other.m2 + delta * delta * static_cast<double>(n) * static_cast<double>(other.n) / total;
+        n += other.n;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+    // population standard deviation (as printed by AnalyzeMappings)
+    [[nodiscard]] double Stddev() const { return n == 0 ? 0.0 : std::sqrt(m2 / static_cast<double>(n)); }
+};
+
+// Histogram with unit-width bins starting at 0, the last bin collects all larger values (and negative values go to bin 0)
+struct UnitHistogram {
+    static constexpr size_t MAX_BINS = 4096;
+    std::vector<uint64_t> bins;
+
+    void Add(double value) {
+        const size_t bin = value <= 0.0 ? 0 : std::min(static_cast<size_t>(value), MAX_BINS - 1);
+        if (bin >= bins.size()) {
+            bins.resize(bin + 1, 0);
+        }
+        ++bins[bin];
+    }
+    void Merge(const UnitHistogram& other) {
+        if (other.bins.size() > bins.size()) {
+            bins.resize(other.bins.size(), 0);
+        }
+        for (size_t i = 0; i < other.bins.size(); ++i) {
+            bins[i] += other.bins[i];
+        }
+    }
+};
+
+// Summary of all mappings of a store, distance = GED estimate and gap = upper_bound - lower_bound
+struct MappingSummary {
+    MomentAccumulator distance;
+    MomentAccumulator gap;
+    UnitHistogram distance_histogram;
+    UnitHistogram gap_histogram;
+    uint64_t valid = 0;
+    uint64_t invalid = 0;
+    // mappings with a zero gap, i.e. proven optimal
+    uint64_t exact = 0;
+
+    void Add(const GEDEvaluation<UDataGraph>& result, bool is_valid) {
+        const double result_gap = result.upper_bound - result.lower_bound;
+        distance.Add(result.distance);
+        gap.Add(result_gap);
+        distance_histogram.Add(result.distance);
+        gap_histogram.Add(result_gap);
+        ++(is_valid ? valid : invalid);
+        exact += result_gap <= 0.0 ? 1 : 0;
+    }
+    void Merge(const MappingSummary& other) {
+        distance.Merge(other.distance);
+        gap.Merge(other.gap);
+        distance_histogram.Merge(other.distance_histogram);
+        gap_histogram.Merge(other.gap_histogram);
+        valid += other.valid;
+        invalid += other.invalid;
+        exact += other.exact;
+    }
+    [[nodiscard]] uint64_t count() const { return distance.n; }
+    void Print(const std::string& name) const;
+};
+
+inline void MappingSummary::Print(const std::string &name) const {
+    std::cout << "Statistics for " << name << ":\n";
+    std::cout << "  Count: " << count() << "\n";
+    if (count() == 0) return;
+    std::cout << "  Mean: " << distance.mean << "\n";
+    std::cout << "  Stddev: " << distance.Stddev() << "\n";
+    std::cout << "  Min: " << distance.min << "\n";
+    std::cout << "  Max: " << distance.max << "\n";
+    std::cout << "  Valid: " << valid << ", invalid: " << invalid << ", exact (zero gap): " << exact << "\n";
+    std::cout << "  Gap (upper - lower bound): mean " << gap.mean << ", stddev " << gap.Stddev() << ", max " << gap.max << "\n";
+    auto print_histogram = [](const std::string& histogram_name, const UnitHistogram& histogram) {
+        std::cout << "  " << histogram_name << " histogram (unit bins):";
+        for (size_t i = 0; i < histogram.bins.size(); ++i) {
+            if (histogram.bins[i] > 0) {
+                std::cout << " " << i << (i + 1 == UnitHistogram::MAX_BINS ? "+" : "") << ":" << histogram.bins[i];
+            }
+        }
+        std::cout << "\n";
+    };
+    print_histogram("Distance", distance_histogram);
+    print_histogram("Gap", gap_histogram);
+}
+
+// Validity flag per mapping (see CheckResultsValidity)
+inline std::vector<char> MappingValidity(const std::vector<GEDEvaluation<UDataGraph>>& results) {
+    std::vector<char> is_valid(results.size(), 1);
+    for (const auto id : CheckResultsValidity(results)) {
+        is_valid[id] = 0;
+    }
+    return is_valid;
+}
+
+// Summary of the given mappings, accumulated per thread and merged
+inline MappingSummary SummarizeMappings(const std::vector<GEDEvaluation<UDataGraph>>& results, const std::vector<char>& is_valid) {
+    std::vector<MappingSummary> thread_summaries(omp_get_max_threads());
+#pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < results.size(); ++i) {
+        thread_summaries[omp_get_thread_num()].Add(results[i], is_valid[i]);
+    }
+    MappingSummary summary;
+    for (const auto& thread_summary : thread_summaries) {
+        summary.Merge(thread_summary);
+    }
+    return summary;
+}
+
+// Identifies the mapping file the metadata belongs to, metadata of a changed file is stale
+struct MappingFileFingerprint {
+    uint64_t size = 0;
+    int64_t modified = 0;
+
+    static MappingFileFingerprint Of(const std::string& path) {
+        std::error_code error;
+        MappingFileFingerprint fingerprint;
+        fingerprint.size = std::filesystem::file_size(path, error);
+        if (error) {
+            return {};
+        }
+        fingerprint.modified = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+        return fingerprint;
+    }
+    bool operator==(const MappingFileFingerprint&) const = default;
+};
+
+constexpr uint64_t MAPPING_META_MAGIC = 0x4154454d50414d47ULL; // "GMAPMETA"
+constexpr uint32_t MAPPING_META_VERSION = 1;
+
+inline std::string MappingFile(const std::string& db_dir, const std::string& db) {
+    return db_dir + db + "_ged_mapping.bin";
+}
+
+inline std::string MappingMetaFile(const std::string& db_dir, const std::string& db) {
+    return db_dir + db + "_ged_mapping.meta";
+}
+
+inline bool WriteMappingSummary(const std::string& db_dir, const std::string& db, const MappingSummary& summary) {
+    const std::string path = MappingMetaFile(db_dir, db);
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "Could not write mapping metadata " << path << std::endl;
+        return false;
+    }
+    auto write = [&out](const auto& value) { out.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+    auto write_moments = [&write](const MomentAccumulator& moments) {
+        write(moments.n);
+        write(moments.mean);
+        write(moments.m2);
+        write(moments.min);
+        write(moments.max);
+    };
+    auto write_histogram = [&](const UnitHistogram& histogram) {
+        write(static_cast<uint64_t>(histogram.bins.size()));
+        out.write(reinterpret_cast<const char*>(histogram.bins.data()), static_cast<std::streamsize>(histogram.bins.size() * sizeof(uint64_t)));
+    };
+    const MappingFileFingerprint fingerprint = MappingFileFingerprint::Of(MappingFile(db_dir, db));
+    write(MAPPING_META_MAGIC);
+    write(MAPPING_META_VERSION);
+    write(fingerprint.size);
+    write(fingerprint.modified);
+    write_moments(summary.distance);
+    write_moments(summary.gap);
+    write_histogram(summary.distance_histogram);
+    write_histogram(summary.gap_histogram);
+    write(summary.valid);
+    write(summary.invalid);
+    write(summary.exact);
+    return static_cast<bool>(out);
+}
+
+// Read the summary of the mapping store, returns false if there is no metadata or it does not match the mapping file
+inline bool ReadMappingSummary(const std::string& db_dir, const std::string& db, MappingSummary& summary) {
+    std::ifstream in(MappingMetaFile(db_dir, db), std::ios::binary);
+    if (!in.is_open()) {
+        return false;
+    }
+    auto read = [&in](auto& value) { in.read(reinterpret_cast<char*>(&value), sizeof(value)); };
+    auto read_moments = [&read](MomentAccumulator& moments) {
+        read(moments.n);
+        read(moments.mean);
+        read(moments.m2);
+        read(moments.min);
+        read(moments.max);
+    };
+    auto read_histogram = [&](UnitHistogram& histogram) {
+        uint64_t bins = 0;
+        read(bins);
+        if (!in || bins > UnitHistogram::MAX_BINS) {
+            return false;
+        }
+        histogram.bins.resize(bins);
+        in.read(reinterpret_cast<char*>(histogram.bins.data()), static_cast<std::streamsize>(bins * sizeof(uint64_t)));
+        return static_cast<bool>(in);
+    };
+    uint64_t magic = 0;
+    uint32_t version = 0;
+    MappingFileFingerprint fingerprint;
+    read(magic);
+    read(version);
+    read(fingerprint.size);
+    read(fingerprint.modified);
+    if (!in || magic != MAPPING_META_MAGIC || version != MAPPING_META_VERSION || fingerprint != MappingFileFingerprint::Of(MappingFile(db_dir, db))) {
+        return false;
+    }
+    read_moments(summary.distance);
+    read_moments(summary.gap);
+    if (!read_histogram(summary.distance_histogram) || !read_histogram(summary.gap_histogram)) {
+        return false;
+    }
+    read(summary.valid);
+    read(summary.invalid);
+    read(summary.exact);
+    return static_cast<bool>(in);
+}
+
+inline MappingSummary SummarizeMappings(const std::vector<GEDEvaluation<UDataGraph>>& results) {
+    return SummarizeMappings(results, MappingValidity(results));
+}
+
+// Node id type of the node maps as stored in the mapping file
+using MappingNode = decltype(GEDEvaluation<UDataGraph>::node_mapping)::first_type::value_type;
+
+// Fixed-size record of one mapping in the index file. The node maps are not copied, the offsets point into the
+// mapping file (or into the node map entries of the index, see MappingIndexHeader::MAPS_IN_INDEX).
+struct MappingIndexRecord {
+    INDEX source_id = 0;
+    INDEX target_id = 0;
+    double distance = 0.0;
+    double lower_bound = 0.0;
+    double upper_bound = 0.0;
+    uint64_t forward_offset = 0;
+    uint64_t backward_offset = 0;
+    uint32_t forward_size = 0;
+    uint32_t backward_size = 0;
+    uint64_t valid = 0;
+    [[nodiscard]] double gap() const { return upper_bound - lower_bound; }
+};
+
+// Layout of <db>_ged_mapping.idx: header, records sorted by (source, target), node map entries (only with
+// MAPS_IN_INDEX) and the secondary indexes as arrays of record ordinals (per graph id in CSR form, sorted by distance,
+// sorted by gap)
+struct MappingIndexHeader {
+    static constexpr uint64_t MAGIC = 0x58444950414d4447ULL; // "GDMAPIDX"
+    static constexpr uint32_t VERSION = 3;
+    // the node map offsets refer to the node map entries of the index instead of the mapping file
+    static constexpr uint32_t MAPS_IN_INDEX = 1;
+    uint64_t magic = MAGIC;
+    uint32_t version = VERSION;
+    uint32_t flags = 0;
+    // fingerprint of the mapping file the index was built for
+    uint64_t bin_size = 0;
+    int64_t bin_modified = 0;
+    uint64_t num_records = 0;
+    // graph ids are 0 .. num_graphs - 1
+    uint64_t num_graphs = 0;
+    uint64_t num_map_entries = 0;
+    // byte offsets of the arrays
+    uint64_t records = 0;
+    uint64_t map_entries = 0;
+    uint64_t graph_offsets = 0;
+    uint64_t graph_records = 0;
+    uint64_t by_distance = 0;
+    uint64_t by_gap = 0;
+    uint64_t total_bytes = 0;
+};
+
+inline std::string MappingIndexFile(const std::string& db_dir, const std::string& db) {
+    return db_dir + db + "_ged_mapping.idx";
+}
+
+// Byte offsets of the node maps of every mapping in the mapping file written by GEDResultToBinary: the number of
+// mappings (uint64), then per mapping the graph ids (2 x INDEX), distance, lower bound, upper bound and time
+// (4 x double) and both node maps as length (uint64) followed by the node ids. The file is checked against the
+// mappings it was written from, returns false if it does not have this layout.
+inline bool LocateNodeMaps(const std::string& bin_path, const std::vector<GEDEvaluation<UDataGraph>>& results, std::vector<std::pair<uint64_t, uint64_t>>& offsets) {
+    std::ifstream in(bin_path, std::ios::binary);
+    if (!in.is_open()) {
+        return false;
+    }
+    auto read = [&in](auto& value) { return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value))); };
+    std::vector<MappingNode> map;
+    auto locate_map = [&](const std::vector<MappingNode>& expected, uint64_t& offset) {
+        uint64_t length = 0;
+        if (!read(length) || length != expected.size()) {
+            return false;
+        }
+        offset = static_cast<uint64_t>(in.tellg());
+        map.resize(length);
+        in.read(reinterpret_cast<char*>(map.data()), static_cast<std::streamsize>(length * sizeof(MappingNode)));
+        return in && map == expected;
+    };
+    uint64_t count = 0;
+    if (!read(count) || count != results.size()) {
+        return false;
+    }
+    offsets.resize(results.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        INDEX source_id = 0;
+        INDEX target_id = 0;
+        if (!read(source_id) || !read(target_id) || std::pair(source_id, target_id) != results[i].graph_ids) {
+            return false;
+        }
+        in.seekg(4 * sizeof(double), std::ios::cur);
+        if (!locate_map(results[i].node_mapping.first, offsets[i].first) || !locate_map(results[i].node_mapping.second, offsets[i].second)) {
+            return false;
+        }
+    }
+    return in.peek() == std::char_traits<char>::eof();
+}
+
+inline bool WriteMappingIndex(const std::string& db_dir, const std::string& db, const std::vector<GEDEvaluation<UDataGraph>>& results, const std::vector<char>& is_valid) {
+    // records in (source, target) order independent of the order of the mapping file
+    std::vector<uint64_t> order(results.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::sort(order, [&results](uint64_t a, uint64_t b) { return results[a].graph_ids < results[b].graph_ids; });
+
+    MappingIndexHeader header;
+    const MappingFileFingerprint fingerprint = MappingFileFingerprint::Of(MappingFile(db_dir, db));
+    header.bin_size = fingerprint.size;
+    header.bin_modified = fingerprint.modified;
+    header.num_records = results.size();
+    // the node maps are read from the mapping file, they are only copied into the index if its layout is unexpected
+    std::vector<std::pair<uint64_t, uint64_t>> bin_offsets;
+    if (!LocateNodeMaps(MappingFile(db_dir, db), results, bin_offsets)) {
+        std::cout << "Unexpected layout of " << MappingFile(db_dir, db) << ", the mapping index stores its own copy of the node maps" << std::endl;
+        header.flags |= MappingIndexHeader::MAPS_IN_INDEX;
+    }
+    std::vector<MappingIndexRecord> records(results.size());
+    std::vector<MappingNode> map_entries;
+    for (uint64_t ordinal = 0; ordinal < order.size(); ++ordinal) {
+        const auto& result = results[order[ordinal]];
+        auto& record = records[ordinal];
+        record = {result.graph_ids.first, result.graph_ids.second, result.distance, result.lower_bound, result.upper_bound, 0, 0,
+                  static_cast<uint32_t>(result.node_mapping.first.size()), static_cast<uint32_t>(result.node_mapping.second.size()),
+                  static_cast<uint64_t>(is_valid[order[ordinal]])};
+        if (header.flags & MappingIndexHeader::MAPS_IN_INDEX) {
+            record.forward_offset = map_entries.size() * sizeof(MappingNode);
+            map_entries.insert(map_entries.end(), result.node_mapping.first.begin(), result.node_mapping.first.end());
+            record.backward_offset = map_entries.size() * sizeof(MappingNode);
+            map_entries.insert(map_entries.end(), result.node_mapping.second.begin(), result.node_mapping.second.end());
+        }
+        else {
+            record.forward_offset = bin_offsets[order[ordinal]].first;
+            record.backward_offset = bin_offsets[order[ordinal]].second;
+        }
+        header.num_graphs = std::max<uint64_t>(header.num_graphs, std::max(record.source_id, record.target_id) + 1);
+    }
+    header.num_map_entries = map_entries.size();
+
+    // by graph id: every record is listed under its source and its target graph
+    std::vector<uint64_t> graph_offsets(header.num_graphs + 1, 0);
+    for (const auto& record : records) {
+        ++graph_offsets[record.source_id + 1];
+        ++graph_offsets[record.target_id + 1];
+    }
+    std::partial_sum(graph_offsets.begin(), graph_offsets.end(), graph_offsets.begin());
+    std::vector<uint64_t> graph_records(graph_offsets.back());
+    std::vector<uint64_t> fill(graph_offsets.begin(), graph_offsets.end() - 1);
+    for (uint64_t ordinal = 0; ordinal < records.size(); ++ordinal) {
+        graph_records[fill[records[ordinal].source_id]++] = ordinal;
+        graph_records[fill[records[ordinal].target_id]++] = ordinal;
+    }
+    std::vector<uint64_t> by_distance(records.size());
+    std::iota(by_distance.begin(), by_distance.end(), 0);
+    std::ranges::stable_sort(by_distance, {}, [&records](uint64_t ordinal) { return records[ordinal].distance; });
+    std::vector<uint64_t> by_gap(records.size());
+    std::iota(by_gap.begin(), by_gap.end(), 0);
+    std::ranges::stable_sort(by_gap, {}, [&records](uint64_t ordinal) { return records[ordinal].gap(); });
+
+    uint64_t offset = sizeof(MappingIndexHeader);
+    auto place = [&offset](uint64_t bytes) { const uint64_t start = offset; offset += (bytes + 7) / 8 * 8; return start; };
+    header.records = place(records.size() * sizeof(MappingIndexRecord));
+    header.map_entries = place(map_entries.size() * sizeof(MappingNode));
+    header.graph_offsets = place(graph_offsets.size() * sizeof(uint64_t));
+    header.graph_records = place(graph_records.size() * sizeof(uint64_t));
+    header.by_distance = place(by_distance.size() * sizeof(uint64_t));
+    header.by_gap = place(by_gap.size() * sizeof(uint64_t));
+    header.total_bytes = offset;
+
+    const std::string path = MappingIndexFile(db_dir, db);
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "Could not write mapping index " << path << std::endl;
+        return false;
+    }
+    auto write_at = [&out](uint64_t position, const void* data, uint64_t bytes) {
+        out.seekp(static_cast<std::streamoff>(position));
+        out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+    };
+    write_at(0, &header, sizeof(header));
+    write_at(header.records, records.data(), records.size() * sizeof(MappingIndexRecord));
+    write_at(header.map_entries, map_entries.data(), map_entries.size() * sizeof(MappingNode));
+    write_at(header.graph_offsets, graph_offsets.data(), graph_offsets.size() * sizeof(uint64_t));
+    write_at(header.graph_records, graph_records.data(), graph_records.size() * sizeof(uint64_t));
+    write_at(header.by_distance, by_distance.data(), by_distance.size() * sizeof(uint64_t));
+    write_at(header.by_gap, by_gap.data(), by_gap.size() * sizeof(uint64_t));
+    // pad to the full size so the last array can be mapped completely
+    const char zero = 0;
+    write_at(header.total_bytes - 1, &zero, 1);
+    return static_cast<bool>(out);
+}
+
+// Write the mappings of db to db_dir and refresh the metadata and the index, used for every write of a mapping store
+inline void WriteMappingStore(const std::string& db_dir, const std::string& db, const std::vector<GEDEvaluation<UDataGraph>>& results) {
+    GEDResultToBinary(db_dir, results);
+    const std::vector<char> is_valid = MappingValidity(results);
+    WriteMappingSummary(db_dir, db, SummarizeMappings(results, is_valid));
+    WriteMappingIndex(db_dir, db, results, is_valid);
+}
+
+// Read-only memory-mapped view of a mapping index and its mapping file. Queries only touch the records and index pages
+// they need, node maps are only read from the mapping file for the records that are actually requested.
+class MappingIndex {
+public:
+    ~MappingIndex();
+    MappingIndex(const MappingIndex&) = delete;
+    MappingIndex& operator=(const MappingIndex&) = delete;
+    // returns nullptr if there is no index or it does not belong to the current mapping file
+    static std::unique_ptr<MappingIndex> Open(const std::string& db_dir, const std::string& db);
+    [[nodiscard]] uint64_t size() const { return _header->num_records; }
+    [[nodiscard]] uint64_t num_graphs() const { return _header->num_graphs; }
+    [[nodiscard]] const MappingIndexRecord& record(uint64_t ordinal) const { return _records[ordinal]; }
+    // ordinals of the records containing the graph
+    [[nodiscard]] std::span<const uint64_t> ByGraph(INDEX graph_id) const;
+    // ordinals of the records with min <= distance <= max (sorted by distance)
+    [[nodiscard]] std::span<const uint64_t> DistanceRange(double min, double max) const;
+    // ordinals of the records with min <= upper_bound - lower_bound <= max (sorted by gap)
+    [[nodiscard]] std::span<const uint64_t> GapRange(double min, double max) const;
+    // ordinal of the mapping of the (unordered) pair or -1
+    [[nodiscard]] int64_t Find(INDEX a, INDEX b) const;
+    // the full mapping of a record, its graphs are taken from graphs (indexed by graph id)
+    [[nodiscard]] GEDEvaluation<UDataGraph> Decode(uint64_t ordinal, const GraphData<UDataGraph>& graphs) const;
+    // only the node maps of a record (source -> target, target -> source), for tools without the dataset
+    [[nodiscard]] decltype(GEDEvaluation<UDataGraph>::node_mapping) NodeMapping(uint64_t ordinal) const;
+private:
+    MappingIndex(const void* base, size_t bytes, const void* maps, size_t map_bytes) : _base(base), _bytes(bytes), _maps(maps), _map_bytes(map_bytes),
+        _header(At<MappingIndexHeader>(0)), _records(At<MappingIndexRecord>(_header->records)) {}
+    template<typename T>
+    [[nodiscard]] const T* At(uint64_t offset) const { return reinterpret_cast<const T*>(static_cast<const char*>(_base) + offset); }
+    // ordinals in sorted_ordinals whose key lies in [min, max]
+    template<typename Key>
+    [[nodiscard]] std::span<const uint64_t> Range(uint64_t array_offset, double min, double max, Key key) const;
+    const void* _base;
+    size_t _bytes;
+    // mapping file, nullptr if the node maps are stored in the index
+    const void* _maps;
+    size_t _map_bytes;
+    const MappingIndexHeader* _header;
+    const MappingIndexRecord* _records;
+};
+
+inline std::unique_ptr<MappingIndex> MappingIndex::Open(const std::string &db_dir, const std::string &db) {
+    const std::string path = MappingIndexFile(db_dir, db);
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(MappingIndexHeader)) {
+        close(fd);
+        return nullptr;
+    }
+    const size_t bytes = info.st_size;
+    void* base = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        std::cerr << "Could not map mapping index " << path << std::endl;
+        return nullptr;
+    }
+    const auto* header = static_cast<const MappingIndexHeader*>(base);
+    const MappingFileFingerprint fingerprint = MappingFileFingerprint::Of(MappingFile(db_dir, db));
+    if (header->magic != MappingIndexHeader::MAGIC || header->version != MappingIndexHeader::VERSION || header->total_bytes > bytes ||
+        header->bin_size != fingerprint.size || header->bin_modified != fingerprint.modified) {
+        std::cout << "Mapping index " << path << " is outdated" << std::endl;
+        munmap(base, bytes);
+        return nullptr;
+    }
+    if (header->flags & MappingIndexHeader::MAPS_IN_INDEX) {
+        return std::unique_ptr<MappingIndex>(new MappingIndex(base, bytes, nullptr, 0));
+    }
+    const std::string bin_path = MappingFile(db_dir, db);
+    const int bin_fd = open(bin_path.c_str(), O_RDONLY);
+    void* maps = bin_fd < 0 || fingerprint.size == 0 ? MAP_FAILED : mmap(nullptr, fingerprint.size, PROT_READ, MAP_SHARED, bin_fd, 0);
+    if (bin_fd >= 0) {
+        close(bin_fd);
+    }
+    if (maps == MAP_FAILED) {
+        std::cerr << "Could not map mapping file " << bin_path << std::endl;
+        munmap(base, bytes);
+        return nullptr;
+    }
+    return std::unique_ptr<MappingIndex>(new MappingIndex(base, bytes, maps, fingerprint.size));
+}
+
+inline MappingIndex::~MappingIndex() {
+    munmap(const_cast<void*>(_base), _bytes);
+    if (_maps != nullptr) {
+        munmap(const_cast<void*>(_maps), _map_bytes);
+    }
+}
+
+inline std::span<const uint64_t> MappingIndex::ByGraph(INDEX graph_id) const {
+    if (graph_id >= _header->num_graphs) {
+        return {};
+    }
+    const uint64_t* offsets = At<uint64_t>(_header->graph_offsets);
+    return {At<uint64_t>(_header->graph_records) + offsets[graph_id], offsets[graph_id + 1] - offsets[graph_id]};
+}
+
+template<typename Key>
+std::span<const uint64_t> MappingIndex::Range(uint64_t array_offset, double min, double max, Key key) const {
+    const std::span<const uint64_t> sorted(At<uint64_t>(array_offset), _header->num_records);
+    const auto begin = std::ranges::partition_point(sorted, [&](uint64_t ordinal) { return key(_records[ordinal]) < min; });
+    const auto end = std::ranges::partition_point(sorted, [&](uint64_t ordinal) { return key(_records[ordinal]) <= max; });
+    return begin < end ? std::span<const uint64_t>(begin, end) : std::span<const uint64_t>();
+}
+
+inline std::span<const uint64_t> MappingIndex::DistanceRange(double min, double max) const {
+    return Range(_header->by_distance, min, max, [](const MappingIndexRecord& record) { return record.distance; });
+}
+
+inline std::span<const uint64_t> MappingIndex::GapRange(double min, double max) const {
+    return Range(_header->by_gap, min, max, [](const MappingIndexRecord& record) { return record.gap(); });
+}
+
+inline int64_t MappingIndex::Find(INDEX a, INDEX b) const {
+    const std::pair<INDEX, INDEX> key = std::minmax(a, b);
+    const std::span<const MappingIndexRecord> records(_records, _header->num_records);
+    const auto it = std::ranges::lower_bound(records, key, {}, [](const MappingIndexRecord& record) { return std::pair<INDEX, INDEX>(record.source_id, record.target_id); });
+    if (it == records.end() || it->source_id != key.first || it->target_id != key.second) {
+        return -1;
+    }
+    return it - records.begin();
+}
+
+inline decltype(GEDEvaluation<UDataGraph>::node_mapping) MappingIndex::NodeMapping(uint64_t ordinal) const {
+    const MappingIndexRecord& record = _records[ordinal];
+    const char* maps = _maps != nullptr ? static_cast<const char*>(_maps) : At<char>(_header->map_entries);
+    // the node maps in the mapping file are not necessarily aligned
+    auto read_map = [maps](uint64_t offset, uint32_t size, std::vector<MappingNode>& map) {
+        map.resize(size);
+        std::memcpy(map.data(), maps + offset, size * sizeof(MappingNode));
+    };
+    decltype(GEDEvaluation<UDataGraph>::node_mapping) node_mapping;
+    read_map(record.forward_offset, record.forward_size, node_mapping.first);
+    read_map(record.backward_offset, record.backward_size, node_mapping.second);
+    return node_mapping;
+}
+
+inline GEDEvaluation<UDataGraph> MappingIndex::Decode(uint64_t ordinal, const GraphData<UDataGraph>& graphs) const {
+    const MappingIndexRecord& record = _records[ordinal];
+    GEDEvaluation<UDataGraph> result;
+    result.graph_ids = {record.source_id, record.target_id};
+    result.graphs = {graphs.graphData[record.source_id], graphs.graphData[record.target_id]};
+    result.distance = record.distance;
+    result.lower_bound = record.lower_bound;
+    result.upper_bound = record.upper_bound;
+    result.node_mapping = NodeMapping(ordinal);
+    return result;
+}
+
+// Predicates for selecting mappings, evaluated on the index records
+struct MappingSelection {
+    double min_distance = -std::numeric_limits<double>::infinity();
+    double max_distance = std::numeric_limits<double>::infinity();
+    double max_gap = std::numeric_limits<double>::infinity();
+    // sorted graph ids, both graphs of a selected mapping have to be in it (empty = all graphs)
+    std::vector<INDEX> graph_ids;
+    bool valid_only = true;
+    // number of mappings drawn uniformly from the matching ones (0 = all)
+    size_t sample = 0;
+
+    // true if any predicate or the sample size differs from selecting all valid mappings
+    [[nodiscard]] bool active() const {
+        return min_distance != -std::numeric_limits<double>::infinity() || max_distance != std::numeric_limits<double>::infinity() ||
+               max_gap != std::numeric_limits<double>::infinity() || !graph_ids.empty() || sample > 0;
+    }
+
+    [[nodiscard]] bool Matches(const MappingIndexRecord& record) const {
+        return record.distance >= min_distance && record.distance <= max_distance && record.gap() <= max_gap && (!valid_only || record.valid) &&
+               (graph_ids.empty() || (std::ranges::binary_search(graph_ids, record.source_id) && std::ranges::binary_search(graph_ids, record.target_id)));
+    }
+};
+
+// Ordinals (in pair order) of the records matching the selection. The candidates come from the most selective index
+// (graph ids or distance range), the remaining predicates are checked on the fixed-size records.
+inline std::vector<uint64_t> SelectMappings(const MappingIndex& index, const MappingSelection& selection, int seed) {
+    // the candidates come from the most selective of the secondary indexes, Matches checks all other predicates
+    const std::span<const uint64_t> distance_range = index.DistanceRange(selection.min_distance, selection.max_distance);
+    const std::span<const uint64_t> gap_range = index.GapRange(-std::numeric_limits<double>::infinity(), selection.max_gap);
+    uint64_t graph_candidates = 0;
+    for (const INDEX graph_id : selection.graph_ids) {
+        graph_candidates += index.ByGraph(graph_id).size();
+    }
+    std::vector<uint64_t> candidates;
+    if (!selection.graph_ids.empty() && graph_candidates < std::min(distance_range.size(), gap_range.size())) {
+        for (const INDEX graph_id : selection.graph_ids) {
+            for (const uint64_t ordinal : index.ByGraph(graph_id)) {
+                // every record is listed for both of its graphs, take it once (at its source graph)
+                if (index.record(ordinal).source_id == graph_id && selection.Matches(index.record(ordinal))) {
+                    candidates.push_back(ordinal);
+                }
+            }
+        }
+    }
+    else {
+        for (const uint64_t ordinal : gap_range.size() < distance_range.size() ? gap_range : distance_range) {
+            if (selection.Matches(index.record(ordinal))) {
+                candidates.push_back(ordinal);
+            }
+        }
+    }
+    std::ranges::sort(candidates);
+    if (selection.sample > 0 && selection.sample < candidates.size()) {
+        std::ranges::shuffle(candidates, std::mt19937(seed));
+        candidates.resize(selection.sample);
+        std::ranges::sort(candidates);
+    }
+    return candidates;
+}
+
+#endif //GEDPATHS_MAPPING_STORE_H
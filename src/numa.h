@@ -0,0 +1,180 @@
+// NUMA topology detection, thread pinning and per-node replicas of the shared graph store.
+// Reads the topology from sysfs (no libnuma dependency); on single-node machines and non-Linux systems everything
+// degrades to a no-op so the NUMA code paths can be run anywhere.
+
+#ifndef GEDPATHS_NUMA_H
+#define GEDPATHS_NUMA_H
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <sched.h>
+#endif
+#include "src/graph_store.h"
+
+class NumaTopology {
+public:
+    // Detect the NUMA nodes and their cpus (restricted to the cpus this process may run on)
+    static NumaTopology Detect();
+    [[nodiscard]] int nodes() const { return static_cast<int>(_node_cpus.size()); }
+    [[nodiscard]] bool IsMultiNode() const { return _node_cpus.size() > 1; }
+    [[nodiscard]] const std::vector<int>& cpus(int node) const { return _node_cpus[node]; }
+    // Node that worker thread_id is assigned to (round-robin over the nodes)
+    [[nodiscard]] int NodeOfThread(int thread_id) const { return nodes() == 0 ? 0 : thread_id % nodes(); }
+    // Pin the calling thread to all cpus of the node, returns false if pinning is not possible or not needed
+    [[nodiscard]] bool PinCurrentThread(int node) const;
+    void PrintTopology() const;
+private:
+    // parse the sysfs list format, e.g. "0-3,8,10-11"
+    static std::vector<int> ParseList(const std::string& list);
+    std::vector<int> _node_ids;
+    std::vector<std::vector<int>> _node_cpus;
+};
+
+inline std::vector<int> NumaTopology::ParseList(const std::string &list) {
+    std::vector<int> values;
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        if (range.empty() || range == "\n") {
+            continue;
+        }
+        const size_t dash = range.find('-');
+        try {
+            const int first = std::stoi(range.substr(0, dash));
+            const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int value = first; value <= last; ++value) {
+                values.push_back(value);
+            }
+        } catch (...) {
+            return {};
+        }
+    }
+    return values;
+}
+
+inline NumaTopology NumaTopology::Detect() {
+    NumaTopology topology;
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    const bool has_mask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+    std::ifstream online("/sys/devices/system/node/online");
+    std::string node_list;
+    if (online.is_open() && std::getline(online, node_list)) {
+        for (const int node : ParseList(node_list)) {
+            std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            std::string cpu_list;
+            if (!cpulist.is_open() || !std::getline(cpulist, cpu_list)) {
+                continue;
+            }
+            std::vector<int> cpus;
+            for (const int cpu : ParseList(cpu_list)) {
+                if (!has_mask || (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed))) {
+                    cpus.push_back(cpu);
+                }
+            }
+            // memory-only nodes and nodes outside of our cpuset are of no use for workers
+            if (!cpus.empty()) {
+                topology._node_ids.push_back(node);
+                topology._node_cpus.push_back(std::move(cpus));
+            }
+        }
+    }
+#endif
+    return topology;
+}
+
+inline bool NumaTopology::PinCurrentThread(int node) const {
+#ifdef __linux__
+    if (!IsMultiNode() || node < 0 || node >= nodes()) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (const int cpu : _node_cpus[node]) {
+        CPU_SET(cpu, &set);
+    }
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+inline void NumaTopology::PrintTopology() const {
+    std::cout << "NUMA nodes: " << nodes();
+    if (!IsMultiNode()) {
+        std::cout << " (single node, NUMA mode is a no-op)";
+    }
+    std::cout << std::endl;
+    for (int node = 0; node < nodes(); ++node) {
+        std::cout << "  node " << _node_ids[node] << ": " << _node_cpus[node].size() << " cpus" << std::endl;
+    }
+}
+
+// Saves the cpu affinity of the calling thread and restores it when going out of scope, so that pinning a thread
+// (e.g. a worker of the OpenMP pool, which is reused later) does not outlive the pinned region
+class ScopedAffinityRestore {
+public:
+    ScopedAffinityRestore();
+    ~ScopedAffinityRestore();
+    ScopedAffinityRestore(const ScopedAffinityRestore&) = delete;
+    ScopedAffinityRestore& operator=(const ScopedAffinityRestore&) = delete;
+private:
+#ifdef __linux__
+    cpu_set_t _mask{};
+#endif
+    bool _saved = false;
+};
+
+inline ScopedAffinityRestore::ScopedAffinityRestore() {
+#ifdef __linux__
+    CPU_ZERO(&_mask);
+    _saved = sched_getaffinity(0, sizeof(_mask), &_mask) == 0;
+#endif
+}
+
+inline ScopedAffinityRestore::~ScopedAffinityRestore() {
+#ifdef __linux__
+    if (_saved) {
+        sched_setaffinity(0, sizeof(_mask), &_mask);
+    }
+#endif
+}
+
+// One copy of the read-only graph store per NUMA node. Each replica is copied by a thread pinned to its node,
+// so first-touch places the pages in node-local memory. On single-node machines the original store is reused.
+class NumaGraphReplicas {
+public:
+    NumaGraphReplicas(const NumaTopology& topology, const SharedGraphStorePtr& store);
+    [[nodiscard]] const SharedGraphStorePtr& ForNode(int node) const { return _replicas[node % _replicas.size()]; }
+    [[nodiscard]] size_t size() const { return _replicas.size(); }
+private:
+    std::vector<SharedGraphStorePtr> _replicas;
+};
+
+inline NumaGraphReplicas::NumaGraphReplicas(const NumaTopology &topology, const SharedGraphStorePtr &store) {
+    if (!topology.IsMultiNode()) {
+        _replicas.push_back(store);
+        return;
+    }
+    _replicas.resize(topology.nodes());
+    std::vector<std::thread> copy_threads;
+    for (int node = 0; node < topology.nodes(); ++node) {
+        copy_threads.emplace_back([&, node]() {
+            if (!topology.PinCurrentThread(node)) {
+                std::cerr << "Warning: could not pin replica thread to NUMA node " << node << std::endl;
+            }
+            _replicas[node] = std::make_shared<const SharedGraphStore>(*store);
+        });
+    }
+    for (auto& thread : copy_threads) {
+        thread.join();
+    }
+}
+
+#endif //GEDPATHS_NUMA_H
@@ -0,0 +1,143 @@
+// Graph id subsets (-ids_path) and explicit pair lists (-pairs_file) restricting which mappings are computed.
+
+#ifndef GEDPATHS_PAIR_SELECTION_H
+#define GEDPATHS_PAIR_SELECTION_H
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <libGraph.h>
+
+// Read all non-negative integers of a text file. Ids may be separated by whitespace, commas or semicolons,
+// everything after a '#' is a comment. Every non-empty line is returned with its line number. Returns false if the
+// file cannot be read or contains other tokens.
+inline bool read_id_lines(const std::string& path, std::vector<std::pair<size_t, std::vector<INDEX>>>& lines) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        std::cerr << "Could not open " << path << std::endl;
+        return false;
+    }
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(in, line)) {
+        ++line_number;
+        line = line.substr(0, line.find('#'));
+        std::ranges::replace_if(line, [](char c) { return c == ',' || c == ';' || c == '\t'; }, ' ');
+        std::istringstream tokens(line);
+        std::vector<INDEX> ids;
+        std::string token;
+        while (tokens >> token) {
+            INDEX id = 0;
+            const char* end = token.data() + token.size();
+            const auto [ptr, error] = std::from_chars(token.data(), end, id);
+            if (error != std::errc() || ptr != end) {
+                std::cerr << path << ":" << line_number << ": invalid graph id '" << token << "'" << std::endl;
+                return false;
+            }
+            ids.push_back(id);
+        }
+        if (!ids.empty()) {
+            lines.emplace_back(line_number, std::move(ids));
+        }
+    }
+    return true;
+}
+
+// Sorted, unique graph ids of a subset file (any layout, e.g. one id per line)
+inline bool read_graph_ids(const std::string& path, std::vector<INDEX>& graph_ids) {
+    std::vector<std::pair<size_t, std::vector<INDEX>>> lines;
+    if (!read_id_lines(path, lines)) {
+        return false;
+    }
+    for (const auto& [line_number, ids] : lines) {
+        graph_ids.insert(graph_ids.end(), ids.begin(), ids.end());
+    }
+    std::ranges::sort(graph_ids);
+    graph_ids.erase(std::unique(graph_ids.begin(), graph_ids.end()), graph_ids.end());
+    std::cout << "Loaded " << graph_ids.size() << " graph ids from " << path << std::endl;
+    return true;
+}
+
+// Pairs of a pair file (two ids per line). The pairs are canonicalized (smaller id first), self pairs are dropped
+// and duplicates removed; the result is sorted.
+inline bool read_graph_pairs(const std::string& path, std::vector<std::pair<INDEX, INDEX>>& graph_pairs) {
+    std::vector<std::pair<size_t, std::vector<INDEX>>> lines;
+    if (!read_id_lines(path, lines)) {
+        return false;
+    }
+    size_t self_pairs = 0;
+    for (const auto& [line_number, ids] : lines) {
+        if (ids.size() != 2) {
+            std::cerr << path << ":" << line_number << ": expected two graph ids but found " << ids.size() << std::endl;
+            return false;
+        }
+        if (ids[0] == ids[1]) {
+            ++self_pairs;
+            continue;
+        }
+        graph_pairs.emplace_back(std::minmax(ids[0], ids[1]));
+    }
+    const size_t listed = graph_pairs.size();
+    std::ranges::sort(graph_pairs);
+    graph_pairs.erase(std::unique(graph_pairs.begin(), graph_pairs.end()), graph_pairs.end());
+    std::cout << "Loaded " << graph_pairs.size() << " distinct pairs from " << path;
+    if (listed != graph_pairs.size() || self_pairs > 0) {
+        std::cout << " (dropped " << listed - graph_pairs.size() << " duplicates and " << self_pairs << " self pairs)";
+    }
+    std::cout << std::endl;
+    return true;
+}
+
+inline bool check_graph_ids_in_range(const std::vector<INDEX>& graph_ids, INDEX num_graphs, const std::string& source) {
+    if (!graph_ids.empty() && graph_ids.back() >= num_graphs) {
+        std::cerr << "Graph id " << graph_ids.back() << " from " << source << " is out of range (dataset has " << num_graphs << " graphs)" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Keep only the pairs with both graphs in the (sorted) subset, an empty subset keeps all pairs
+inline void restrict_pairs_to_subset(std::vector<std::pair<INDEX, INDEX>>& graph_pairs, const std::vector<INDEX>& graph_ids) {
+    if (graph_ids.empty()) {
+        return;
+    }
+    const size_t before = graph_pairs.size();
+    std::erase_if(graph_pairs, [&graph_ids](const std::pair<INDEX, INDEX>& pair) {
+        return !std::ranges::binary_search(graph_ids, pair.first) || !std::ranges::binary_search(graph_ids, pair.second);
+    });
+    if (graph_pairs.size() != before) {
+        std::cout << "Dropped " << before - graph_pairs.size() << " pairs outside of the graph id subset" << std::endl;
+    }
+}
+
+// Load the subset and pair files (both optional) and check them against the dataset size
+inline bool load_pair_selection(const std::string& graph_ids_path,
+                                const std::string& pairs_file,
+                                INDEX num_graphs,
+                                std::vector<INDEX>& graph_ids,
+                                std::vector<std::pair<INDEX, INDEX>>& explicit_pairs) {
+    if (!graph_ids_path.empty() && (!read_graph_ids(graph_ids_path, graph_ids) || !check_graph_ids_in_range(graph_ids, num_graphs, graph_ids_path))) {
+        return false;
+    }
+    if (!pairs_file.empty()) {
+        if (!read_graph_pairs(pairs_file, explicit_pairs)) {
+            return false;
+        }
+        INDEX max_id = 0;
+        for (const auto& pair : explicit_pairs) {
+            max_id = std::max(max_id, pair.second);
+        }
+        if (!explicit_pairs.empty() && !check_graph_ids_in_range({max_id}, num_graphs, pairs_file)) {
+            return false;
+        }
+        restrict_pairs_to_subset(explicit_pairs, graph_ids);
+    }
+    return true;
+}
+
+#endif //GEDPATHS_PAIR_SELECTION_H
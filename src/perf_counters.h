@@ -0,0 +1,326 @@
+// Optional hardware performance counters (cycles, instructions, cache misses, branch misses) per tool stage.
+// Counters are read with perf_event_open (Linux only). They are disabled by default (-perf / -perf_json) and degrade
+// to wall time only if the kernel refuses them (e.g. perf_event_paranoid, containers, non-Linux systems).
+
+#ifndef GEDPATHS_PERF_COUNTERS_H
+#define GEDPATHS_PERF_COUNTERS_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+enum class PerfCounter { CYCLES, INSTRUCTIONS, CACHE_MISSES, BRANCH_MISSES };
+constexpr size_t PERF_COUNTER_NUM = 4;
+constexpr std::array<const char*, PERF_COUNTER_NUM> PERF_COUNTER_NAMES = {"cycles", "instructions", "cache_misses", "branch_misses"};
+
+struct PerfCounterValues {
+    std::array<uint64_t, PERF_COUNTER_NUM> counters{};
+    double seconds = 0.0;
+    // false if the counters could not be read, then only the wall time is valid
+    bool available = false;
+
+    [[nodiscard]] uint64_t operator[](PerfCounter counter) const { return counters[static_cast<size_t>(counter)]; }
+    PerfCounterValues& operator+=(const PerfCounterValues& other) {
+        for (size_t i = 0; i < PERF_COUNTER_NUM; ++i) {
+            counters[i] += other.counters[i];
+        }
+        seconds += other.seconds;
+        available = available || other.available;
+        return *this;
+    }
+    [[nodiscard]] double IPC() const {
+        return (*this)[PerfCounter::CYCLES] == 0 ? 0.0 : static_cast<double>((*this)[PerfCounter::INSTRUCTIONS]) / static_cast<double>((*this)[PerfCounter::CYCLES]);
+    }
+    // cache misses per 1000 instructions
+    [[nodiscard]] double CacheMPKI() const {
+        return (*this)[PerfCounter::INSTRUCTIONS] == 0 ? 0.0 : 1000.0 * static_cast<double>((*this)[PerfCounter::CACHE_MISSES]) / static_cast<double>((*this)[PerfCounter::INSTRUCTIONS]);
+    }
+    // rough classification: low IPC together with many cache misses points to a memory-bound stage
+    [[nodiscard]] std::string Bound() const {
+        if (!available || (*this)[PerfCounter::CYCLES] == 0) {
+            return "n/a";
+        }
+        if (IPC() < 1.0 && CacheMPKI() > 5.0) {
+            return "memory";
+        }
+        if (IPC() >= 1.5) {
+            return "compute";
+        }
+        return "mixed";
+    }
+};
+
+// Counter group of the calling thread, opened as one perf event group (cycles is the leader) so that all counters are
+// scheduled together and the ratios (IPC, MPKI) refer to the same intervals. The group is opened with inherit if the
+// kernel supports it for groups: threads created while the group is open are counted too, but their counts are only
+// added when they exit. Threads that already existed (e.g. a running OpenMP pool) are never counted.
+class PerfEventGroup {
+public:
+    PerfEventGroup();
+    ~PerfEventGroup();
+    PerfEventGroup(const PerfEventGroup&) = delete;
+    PerfEventGroup& operator=(const PerfEventGroup&) = delete;
+    [[nodiscard]] bool available() const { return _available; }
+    // counter values since construction (scaled if the kernel multiplexed the counters)
+    [[nodiscard]] PerfCounterValues Read() const;
+private:
+    std::array<int, PERF_COUNTER_NUM> _fds{};
+    bool _available = false;
+    std::chrono::steady_clock::time_point _start;
+};
+
+#ifdef __linux__
+// group_fd -1 opens the (disabled) leader, the members are enabled and disabled together with it
+inline int OpenPerfEvent(uint64_t config, int group_fd, bool inherit) {
+    perf_event_attr attr{};
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = group_fd < 0 ? 1 : 0;
+    attr.inherit = inherit ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+#endif
+
+inline PerfEventGroup::PerfEventGroup() {
+    _fds.fill(-1);
+#ifdef __linux__
+    constexpr std::array<uint64_t, PERF_COUNTER_NUM> configs = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+    // older kernels reject inherit for group reads, then only the calling thread is counted
+    for (const bool inherit : {true, false}) {
+        _available = true;
+        for (size_t i = 0; i < PERF_COUNTER_NUM && _available; ++i) {
+            _fds[i] = OpenPerfEvent(configs[i], i == 0 ? -1 : _fds[0], inherit);
+            _available = _fds[i] >= 0;
+        }
+        if (_available) {
+            break;
+        }
+        for (int& fd : _fds) {
+            if (fd >= 0) {
+                close(fd);
+            }
+            fd = -1;
+        }
+    }
+    if (_available) {
+        ioctl(_fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(_fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+    _start = std::chrono::steady_clock::now();
+}
+
+inline PerfEventGroup::~PerfEventGroup() {
+#ifdef __linux__
+    for (const int fd : _fds) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+#endif
+}
+
+inline PerfCounterValues PerfEventGroup::Read() const {
+    PerfCounterValues values;
+    values.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+#ifdef __linux__
+    if (!_available) {
+        return values;
+    }
+    // one read of the leader: number of counters, time enabled, time running and the values in opening order
+    std::array<uint64_t, 3 + PERF_COUNTER_NUM> data{};
+    if (read(_fds[0], data.data(), sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[0] != PERF_COUNTER_NUM) {
+        return values;
+    }
+    values.available = true;
+    for (size_t i = 0; i < PERF_COUNTER_NUM; ++i) {
+        // the group is scheduled as a whole, so one scaling factor applies to all counters
+        values.counters[i] = data[2] == 0 ? 0 : static_cast<uint64_t>(static_cast<double>(data[3 + i]) * static_cast<double>(data[1]) / static_cast<double>(data[2]));
+    }
+#endif
+    return values;
+}
+
+// Process-wide collection of the stage measurements, aggregated per stage and per thread
+class PerfCounters {
+public:
+    static PerfCounters& Instance() {
+        static PerfCounters instance;
+        return instance;
+    }
+    void Enable() { _enabled = true; }
+    [[nodiscard]] bool enabled() const { return _enabled; }
+    void Add(const std::string& stage, int thread_id, const PerfCounterValues& values);
+    // Table of all stages (no-op if disabled)
+    void PrintSummary() const;
+    // JSON report with the totals and the per-thread values of all stages
+    bool WriteJSON(const std::string& path, const std::string& tool) const;
+    // Print the summary and write the JSON report if a path is given, called at the end of every tool
+    void Report(const std::string& tool, const std::string& json_path) const;
+private:
+    struct Stage {
+        std::string name;
+        std::map<int, PerfCounterValues> threads;
+        [[nodiscard]] PerfCounterValues Total() const;
+        // wall time of the stage is the time of its slowest thread
+        [[nodiscard]] double WallSeconds() const;
+    };
+    bool _enabled = false;
+    mutable std::mutex _mutex;
+    // stages in the order they were first reported
+    std::vector<Stage> _stages;
+    bool _warned = false;
+};
+
+inline void PerfCounters::Add(const std::string &stage, int thread_id, const PerfCounterValues &values) {
+    std::lock_guard lock(_mutex);
+    if (!values.available && !_warned) {
+        std::cerr << "Warning: hardware performance counters are not available (check /proc/sys/kernel/perf_event_paranoid), reporting wall times only" << std::endl;
+        _warned = true;
+    }
+    auto it = std::ranges::find_if(_stages, [&stage](const Stage& s) { return s.name == stage; });
+    if (it == _stages.end()) {
+        _stages.push_back({stage, {}});
+        it = std::prev(_stages.end());
+    }
+    it->threads[thread_id] += values;
+}
+
+inline PerfCounterValues PerfCounters::Stage::Total() const {
+    PerfCounterValues total;
+    for (const auto& [thread_id, values] : threads) {
+        total += values;
+    }
+    return total;
+}
+
+inline double PerfCounters::Stage::WallSeconds() const {
+    double wall = 0.0;
+    for (const auto& [thread_id, values] : threads) {
+        wall = std::max(wall, values.seconds);
+    }
+    return wall;
+}
+
+inline void PerfCounters::PrintSummary() const {
+    if (!_enabled) {
+        return;
+    }
+    std::lock_guard lock(_mutex);
+    std::cout << "Performance counters per stage:" << std::endl;
+    std::cout << std::left << std::setw(28) << "  stage" << std::right << std::setw(8) << "threads" << std::setw(12) << "wall [s]"
+              << std::setw(16) << "cycles" << std::setw(16) << "instructions" << std::setw(8) << "IPC"
+              << std::setw(14) << "cache miss" << std::setw(8) << "MPKI" << std::setw(14) << "branch miss" << std::setw(10) << "bound" << std::endl;
+    for (const auto& stage : _stages) {
+        const PerfCounterValues total = stage.Total();
+        std::cout << std::left << std::setw(28) << "  " + stage.name << std::right << std::setw(8) << stage.threads.size()
+                  << std::setw(12) << std::fixed << std::setprecision(3) << stage.WallSeconds();
+        if (total.available) {
+            std::cout << std::setw(16) << total[PerfCounter::CYCLES] << std::setw(16) << total[PerfCounter::INSTRUCTIONS]
+                      << std::setw(8) << std::setprecision(2) << total.IPC() << std::setw(14) << total[PerfCounter::CACHE_MISSES]
+                      << std::setw(8) << total.CacheMPKI() << std::setw(14) << total[PerfCounter::BRANCH_MISSES];
+        }
+        else {
+            std::cout << std::setw(16) << "-" << std::setw(16) << "-" << std::setw(8) << "-" << std::setw(14) << "-" << std::setw(8) << "-" << std::setw(14) << "-";
+        }
+        std::cout << std::setw(10) << total.Bound() << std::defaultfloat << std::endl;
+    }
+}
+
+inline void WritePerfValuesJSON(std::ostream& out, const PerfCounterValues& values) {
+    out << "\"seconds\": " << values.seconds << ", \"counters_available\": " << (values.available ? "true" : "false");
+    if (values.available) {
+        for (size_t i = 0; i < PERF_COUNTER_NUM; ++i) {
+            out << ", \"" << PERF_COUNTER_NAMES[i] << "\": " << values.counters[i];
+        }
+        out << ", \"ipc\": " << values.IPC() << ", \"cache_mpki\": " << values.CacheMPKI();
+    }
+    out << ", \"bound\": \"" << values.Bound() << "\"";
+}
+
+inline bool PerfCounters::WriteJSON(const std::string &path, const std::string &tool) const {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "Could not write performance report " << path << std::endl;
+        return false;
+    }
+    std::lock_guard lock(_mutex);
+    out << "{\n  \"tool\": \"" << tool << "\",\n  \"stages\": [";
+    for (size_t s = 0; s < _stages.size(); ++s) {
+        const auto& stage = _stages[s];
+        out << (s == 0 ? "\n" : ",\n") << "    {\"name\": \"" << stage.name << "\", \"wall_seconds\": " << stage.WallSeconds()
+            << ", \"threads\": " << stage.threads.size() << ", \"total\": {";
+        WritePerfValuesJSON(out, stage.Total());
+        out << "}, \"per_thread\": [";
+        bool first = true;
+        for (const auto& [thread_id, values] : stage.threads) {
+            out << (first ? "" : ", ") << "{\"thread\": " << thread_id << ", ";
+            WritePerfValuesJSON(out, values);
+            out << "}";
+            first = false;
+        }
+        out << "]}";
+    }
+    out << "\n  ]\n}\n";
+    std::cout << "Wrote performance report to " << path << std::endl;
+    return true;
+}
+
+inline void PerfCounters::Report(const std::string &tool, const std::string &json_path) const {
+    if (!_enabled) {
+        return;
+    }
+    PrintSummary();
+    if (!json_path.empty()) {
+        WriteJSON(json_path, tool);
+    }
+}
+
+// Measures the enclosing scope as one stage of the calling thread, e.g.
+//     { ScopedPerfStage stage("load_graphs"); ... }
+// In parallel regions every worker opens its own scope with its thread id. Costs nothing if the counters are disabled.
+class ScopedPerfStage {
+public:
+    explicit ScopedPerfStage(std::string stage, int thread_id = 0) : _stage(std::move(stage)), _thread_id(thread_id) {
+        if (PerfCounters::Instance().enabled()) {
+            _group = std::make_unique<PerfEventGroup>();
+        }
+    }
+    ~ScopedPerfStage() { Stop(); }
+    ScopedPerfStage(const ScopedPerfStage&) = delete;
+    ScopedPerfStage& operator=(const ScopedPerfStage&) = delete;
+    // end the stage before the end of the scope
+    void Stop() {
+        if (_group) {
+            PerfCounters::Instance().Add(_stage, _thread_id, _group->Read());
+            _group.reset();
+        }
+    }
+private:
+    std::string _stage;
+    int _thread_id;
+    std::unique_ptr<PerfEventGroup> _group;
+};
+
+#endif //GEDPATHS_PERF_COUNTERS_H
@@ -0,0 +1,325 @@
+// Shared-memory (shm_open + mmap) copy of the graph store and of the existing mappings.
+// The coordinator publishes the segment once, worker processes attach read-only and use it without loading the dataset
+// or the mapping file. All structures inside the segment are addressed by byte offsets from the segment start, so the
+// segment can be mapped at any address.
+
+#ifndef GEDPATHS_SHM_STORE_H
+#define GEDPATHS_SHM_STORE_H
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "src/graph_store.h"
+
+struct ShmStoreHeader {
+    static constexpr uint64_t MAGIC = 0x4745445041544853; // "GEDPATHS"
+    static constexpr uint32_t VERSION = 1;
+    uint64_t magic = MAGIC;
+    uint32_t version = VERSION;
+    // set to 1 after the segment is completely written
+    uint32_t ready = 0;
+    uint64_t total_bytes = 0;
+    // graph store
+    uint64_t num_graphs = 0;
+    uint64_t num_nodes = 0;
+    uint64_t num_edges = 0;
+    uint64_t num_adjacency = 0;
+    uint64_t name_bytes = 0;
+    uint64_t node_offsets = 0;      // uint64_t[num_graphs + 1]
+    uint64_t node_labels = 0;       // GraphStoreLabel[num_nodes]
+    uint64_t edge_offsets = 0;      // uint64_t[num_graphs + 1]
+    uint64_t edges = 0;             // GraphStoreEdge[num_edges]
+    uint64_t adjacency_offsets = 0; // uint64_t[num_nodes + 1]
+    uint64_t adjacency = 0;         // INDEX[num_adjacency]
+    uint64_t name_offsets = 0;      // uint64_t[num_graphs + 1]
+    uint64_t names = 0;             // char[name_bytes]
+    // mappings
+    uint64_t num_mappings = 0;
+    uint64_t num_map_entries = 0;
+    uint64_t mappings = 0;          // ShmMappingRecord[num_mappings]
+    uint64_t map_entries = 0;       // INDEX[num_map_entries]
+};
+
+// One mapping; the forward map (source nodes) and the backward map (target nodes) are stored back to back
+// in the map entries starting at map_offset
+struct ShmMappingRecord {
+    INDEX source_id = 0;
+    INDEX target_id = 0;
+    double distance = 0.0;
+    double lower_bound = 0.0;
+    double upper_bound = 0.0;
+    uint64_t map_offset = 0;
+    uint64_t forward_size = 0;
+    uint64_t backward_size = 0;
+};
+
+// Read-only view of an attached segment, offers the same graph accessors as SharedGraphStore
+class ShmGraphStore {
+public:
+    ~ShmGraphStore();
+    ShmGraphStore(const ShmGraphStore&) = delete;
+    ShmGraphStore& operator=(const ShmGraphStore&) = delete;
+
+    // Coordinator: write store and mappings into the segment called name (an existing segment is replaced)
+    static bool Publish(const std::string& name, const SharedGraphStore& store, const std::vector<GEDEvaluation<UDataGraph>>& mappings);
+    // Worker: map the segment read-only, returns nullptr if it does not exist or is not valid
+    static std::unique_ptr<ShmGraphStore> Attach(const std::string& name);
+    static bool Unlink(const std::string& name);
+
+    [[nodiscard]] INDEX size() const { return _header->num_graphs; }
+    [[nodiscard]] INDEX nodes(INDEX graph_id) const { return _node_offsets[graph_id + 1] - _node_offsets[graph_id]; }
+    [[nodiscard]] INDEX edges(INDEX graph_id) const { return _edge_offsets[graph_id + 1] - _edge_offsets[graph_id]; }
+    [[nodiscard]] std::string_view name(INDEX graph_id) const;
+    [[nodiscard]] std::span<const GraphStoreLabel> node_labels(INDEX graph_id) const;
+    [[nodiscard]] std::span<const GraphStoreEdge> edge_list(INDEX graph_id) const;
+    [[nodiscard]] std::span<const INDEX> neighbors(INDEX graph_id, INDEX node) const;
+
+    [[nodiscard]] std::span<const ShmMappingRecord> mappings() const { return {_mappings, _header->num_mappings}; }
+    [[nodiscard]] std::span<const INDEX> forward_map(const ShmMappingRecord& record) const { return {_map_entries + record.map_offset, record.forward_size}; }
+    [[nodiscard]] std::span<const INDEX> backward_map(const ShmMappingRecord& record) const { return {_map_entries + record.map_offset + record.forward_size, record.backward_size}; }
+    // Mapping of the (unordered) pair or nullptr, records are sorted by graph ids
+    [[nodiscard]] const ShmMappingRecord* FindMapping(INDEX source_id, INDEX target_id) const;
+
+private:
+    ShmGraphStore(const void* base, size_t bytes);
+    // shm_open needs a name with a single leading slash
+    static std::string SegmentName(const std::string& name);
+    template <typename T>
+    const T* At(uint64_t offset) const { return reinterpret_cast<const T*>(static_cast<const char*>(_base) + offset); }
+
+    const void* _base = nullptr;
+    size_t _bytes = 0;
+    const ShmStoreHeader* _header = nullptr;
+    const uint64_t* _node_offsets = nullptr;
+    const GraphStoreLabel* _node_labels = nullptr;
+    const uint64_t* _edge_offsets = nullptr;
+    const GraphStoreEdge* _edges = nullptr;
+    const uint64_t* _adjacency_offsets = nullptr;
+    const INDEX* _adjacency = nullptr;
+    const uint64_t* _name_offsets = nullptr;
+    const char* _names = nullptr;
+    const ShmMappingRecord* _mappings = nullptr;
+    const INDEX* _map_entries = nullptr;
+};
+
+inline std::string ShmGraphStore::SegmentName(const std::string &name) {
+    return name.starts_with('/') ? name : "/" + name;
+}
+
+inline bool ShmGraphStore::Publish(const std::string &name, const SharedGraphStore &store, const std::vector<GEDEvaluation<UDataGraph>> &mappings) {
+    ShmStoreHeader header;
+    header.num_graphs = store.size();
+    for (INDEX graph_id = 0; graph_id < store.size(); ++graph_id) {
+        header.num_nodes += store.nodes(graph_id);
+        header.num_edges += store.edges(graph_id);
+        header.name_bytes += store.name(graph_id).size();
+        for (INDEX node = 0; node < store.nodes(graph_id); ++node) {
+            header.num_adjacency += store.neighbors(graph_id, node).size();
+        }
+    }
+    header.num_mappings = mappings.size();
+    for (const auto& mapping : mappings) {
+        header.num_map_entries += mapping.node_mapping.first.size() + mapping.node_mapping.second.size();
+    }
+
+    // lay out the arrays one after another, each aligned to 8 bytes
+    uint64_t offset = sizeof(ShmStoreHeader);
+    auto place = [&offset](uint64_t bytes) {
+        const uint64_t start = (offset + 7) & ~uint64_t{7};
+        offset = start + bytes;
+        return start;
+    };
+    header.node_offsets = place((header.num_graphs + 1) * sizeof(uint64_t));
+    header.node_labels = place(header.num_nodes * sizeof(GraphStoreLabel));
+    header.edge_offsets = place((header.num_graphs + 1) * sizeof(uint64_t));
+    header.edges = place(header.num_edges * sizeof(GraphStoreEdge));
+    header.adjacency_offsets = place((header.num_nodes + 1) * sizeof(uint64_t));
+    header.adjacency = place(header.num_adjacency * sizeof(INDEX));
+    header.name_offsets = place((header.num_graphs + 1) * sizeof(uint64_t));
+    header.names = place(header.name_bytes);
+    header.mappings = place(header.num_mappings * sizeof(ShmMappingRecord));
+    header.map_entries = place(header.num_map_entries * sizeof(INDEX));
+    header.total_bytes = (offset + 7) & ~uint64_t{7};
+
+    const std::string segment = SegmentName(name);
+    shm_unlink(segment.c_str());
+    const int fd = shm_open(segment.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        std::cerr << "Could not create shared memory segment " << segment << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(header.total_bytes)) != 0) {
+        std::cerr << "Could not resize shared memory segment " << segment << ": " << std::strerror(errno) << std::endl;
+        close(fd);
+        shm_unlink(segment.c_str());
+        return false;
+    }
+    void* base = mmap(nullptr, header.total_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        std::cerr << "Could not map shared memory segment " << segment << ": " << std::strerror(errno) << std::endl;
+        shm_unlink(segment.c_str());
+        return false;
+    }
+    char* bytes = static_cast<char*>(base);
+    auto* segment_header = new (bytes) ShmStoreHeader(header);
+    auto* node_offsets = reinterpret_cast<uint64_t*>(bytes + header.node_offsets);
+    auto* node_labels = reinterpret_cast<GraphStoreLabel*>(bytes + header.node_labels);
+    auto* edge_offsets = reinterpret_cast<uint64_t*>(bytes + header.edge_offsets);
+    auto* edges = reinterpret_cast<GraphStoreEdge*>(bytes + header.edges);
+    auto* adjacency_offsets = reinterpret_cast<uint64_t*>(bytes + header.adjacency_offsets);
+    auto* adjacency = reinterpret_cast<INDEX*>(bytes + header.adjacency);
+    auto* name_offsets = reinterpret_cast<uint64_t*>(bytes + header.name_offsets);
+    char* names = bytes + header.names;
+
+    uint64_t node_count = 0, edge_count = 0, adjacency_count = 0, name_count = 0;
+    node_offsets[0] = edge_offsets[0] = adjacency_offsets[0] = name_offsets[0] = 0;
+    for (INDEX graph_id = 0; graph_id < store.size(); ++graph_id) {
+        for (INDEX node = 0; node < store.nodes(graph_id); ++node) {
+            node_labels[node_count++] = store.node_labels(graph_id)[node];
+            for (const INDEX neighbor : store.neighbors(graph_id, node)) {
+                adjacency[adjacency_count++] = neighbor;
+            }
+            adjacency_offsets[node_count] = adjacency_count;
+        }
+        for (const auto& edge : store.edge_list(graph_id)) {
+            edges[edge_count++] = edge;
+        }
+        const std::string& graph_name = store.name(graph_id);
+        std::memcpy(names + name_count, graph_name.data(), graph_name.size());
+        name_count += graph_name.size();
+        node_offsets[graph_id + 1] = node_count;
+        edge_offsets[graph_id + 1] = edge_count;
+        name_offsets[graph_id + 1] = name_count;
+    }
+
+    // mappings sorted by graph ids for the binary search in FindMapping
+    std::vector<size_t> order(mappings.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::sort(order, [&mappings](size_t a, size_t b) {
+        return mappings[a].graph_ids < mappings[b].graph_ids;
+    });
+    auto* records = reinterpret_cast<ShmMappingRecord*>(bytes + header.mappings);
+    auto* map_entries = reinterpret_cast<INDEX*>(bytes + header.map_entries);
+    uint64_t map_count = 0;
+    for (size_t i = 0; i < order.size(); ++i) {
+        const auto& mapping = mappings[order[i]];
+        ShmMappingRecord& record = records[i];
+        record = ShmMappingRecord{mapping.graph_ids.first, mapping.graph_ids.second, mapping.distance,
+                                  mapping.lower_bound, mapping.upper_bound, map_count,
+                                  mapping.node_mapping.first.size(), mapping.node_mapping.second.size()};
+        for (const auto node : mapping.node_mapping.first) {
+            map_entries[map_count++] = node;
+        }
+        for (const auto node : mapping.node_mapping.second) {
+            map_entries[map_count++] = node;
+        }
+    }
+    // workers only accept the segment once everything above is visible
+    std::atomic_ref<uint32_t>(segment_header->ready).store(1, std::memory_order_release);
+    munmap(base, header.total_bytes);
+    std::cout << "Published " << header.num_graphs << " graphs and " << header.num_mappings << " mappings to shared memory "
+              << segment << " (" << header.total_bytes / (1024.0 * 1024.0) << " MB)" << std::endl;
+    return true;
+}
+
+inline std::unique_ptr<ShmGraphStore> ShmGraphStore::Attach(const std::string &name) {
+    const std::string segment = SegmentName(name);
+    const int fd = shm_open(segment.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        std::cerr << "Could not open shared memory segment " << segment << ": " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(ShmStoreHeader)) {
+        std::cerr << "Shared memory segment " << segment << " is too small" << std::endl;
+        close(fd);
+        return nullptr;
+    }
+    const size_t bytes = info.st_size;
+    void* base = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        std::cerr << "Could not map shared memory segment " << segment << ": " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+    const auto* header = static_cast<const ShmStoreHeader*>(base);
+    if (header->magic != ShmStoreHeader::MAGIC || header->version != ShmStoreHeader::VERSION ||
+        std::atomic_ref<const uint32_t>(header->ready).load(std::memory_order_acquire) != 1 || header->total_bytes > bytes) {
+        std::cerr << "Shared memory segment " << segment << " is not a (complete) GEDPaths store" << std::endl;
+        munmap(base, bytes);
+        return nullptr;
+    }
+    return std::unique_ptr<ShmGraphStore>(new ShmGraphStore(base, bytes));
+}
+
+inline bool ShmGraphStore::Unlink(const std::string &name) {
+    const std::string segment = SegmentName(name);
+    if (shm_unlink(segment.c_str()) != 0) {
+        std::cerr << "Could not remove shared memory segment " << segment << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+}
+
+inline ShmGraphStore::ShmGraphStore(const void *base, size_t bytes) : _base(base), _bytes(bytes) {
+    _header = At<ShmStoreHeader>(0);
+    _node_offsets = At<uint64_t>(_header->node_offsets);
+    _node_labels = At<GraphStoreLabel>(_header->node_labels);
+    _edge_offsets = At<uint64_t>(_header->edge_offsets);
+    _edges = At<GraphStoreEdge>(_header->edges);
+    _adjacency_offsets = At<uint64_t>(_header->adjacency_offsets);
+    _adjacency = At<INDEX>(_header->adjacency);
+    _name_offsets = At<uint64_t>(_header->name_offsets);
+    _names = At<char>(_header->names);
+    _mappings = At<ShmMappingRecord>(_header->mappings);
+    _map_entries = At<INDEX>(_header->map_entries);
+}
+
+inline ShmGraphStore::~ShmGraphStore() {
+    munmap(const_cast<void*>(_base), _bytes);
+}
+
+inline std::string_view ShmGraphStore::name(INDEX graph_id) const {
+    return {_names + _name_offsets[graph_id], _name_offsets[graph_id + 1] - _name_offsets[graph_id]};
+}
+
+inline std::span<const GraphStoreLabel> ShmGraphStore::node_labels(INDEX graph_id) const {
+    return {_node_labels + _node_offsets[graph_id], nodes(graph_id)};
+}
+
+inline std::span<const GraphStoreEdge> ShmGraphStore::edge_list(INDEX graph_id) const {
+    return {_edges + _edge_offsets[graph_id], edges(graph_id)};
+}
+
+inline std::span<const INDEX> ShmGraphStore::neighbors(INDEX graph_id, INDEX node) const {
+    const uint64_t global_node = _node_offsets[graph_id] + node;
+    return {_adjacency + _adjacency_offsets[global_node], _adjacency_offsets[global_node + 1] - _adjacency_offsets[global_node]};
+}
+
+inline const ShmMappingRecord* ShmGraphStore::FindMapping(INDEX source_id, INDEX target_id) const {
+    const std::pair<INDEX, INDEX> key = std::minmax(source_id, target_id);
+    const auto records = mappings();
+    const auto it = std::ranges::lower_bound(records, key, {}, [](const ShmMappingRecord& record) {
+        return std::pair<INDEX, INDEX>(record.source_id, record.target_id);
+    });
+    if (it == records.end() || it->source_id != key.first || it->target_id != key.second) {
+        return nullptr;
+    }
+    return &*it;
+}
+
+#endif //GEDPATHS_SHM_STORE_H
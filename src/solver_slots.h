@@ -0,0 +1,190 @@
+// Machine-wide cap on the number of concurrent Gurobi solves of all GEDPaths processes (the license limits them).
+// Slot i is the lock file <directory>/slot_<i>.lock and is held with an exclusive flock, so slots of crashed processes
+// are freed by the kernel. Only the MIP-based methods take slots; heuristic methods, path generation and the
+// analysis tools never wait and keep the remaining cores busy.
+
+#ifndef GEDPATHS_SOLVER_SLOTS_H
+#define GEDPATHS_SOLVER_SLOTS_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#include <src/env/ged_env.hpp>
+
+// True if the method solves MIPs with Gurobi, directly (F1, F2, COMPACT_MIP, BLP_NO_EDGE_LABELS) or for its subproblems
+inline bool UsesGurobi(ged::Options::GEDMethod ged_method, const std::string& method_options) {
+#ifdef GUROBI
+    if (ged_method == ged::Options::GEDMethod::F1 || ged_method == ged::Options::GEDMethod::F2 ||
+        ged_method == ged::Options::GEDMethod::COMPACT_MIP || ged_method == ged::Options::GEDMethod::BLP_NO_EDGE_LABELS) {
+        return true;
+    }
+    for (const std::string solver : {"F1", "F2", "COMPACT_MIP"}) {
+        if (method_options.find("--subproblem-solver " + solver) != std::string::npos) {
+            return true;
+        }
+    }
+#endif
+    return false;
+}
+
+// Value of --threads in the method options (GEDLIB's default is 1). A Gurobi-based method may run that many solves at once.
+inline int MethodThreads(const std::string& method_options) {
+    std::istringstream options(method_options);
+    std::string option;
+    int threads = 1;
+    while (options >> option) {
+        if (option == "--threads" && options >> option) {
+            try {
+                threads = std::max(1, std::stoi(option));
+            } catch (...) {
+                threads = 1;
+            }
+        }
+    }
+    return threads;
+}
+
+class SolverSlots {
+public:
+    static SolverSlots& Instance() {
+        static SolverSlots instance;
+        return instance;
+    }
+    // slots <= 0 disables the cap. All processes sharing the license should use the same number and directory.
+    bool Configure(int slots, const std::string& directory);
+    [[nodiscard]] bool enabled() const { return _slots > 0; }
+    [[nodiscard]] int slots() const { return _slots; }
+    // Block until count slots (at most all slots) are free at the same time and hold them, returns the file descriptors
+    // of their lock files
+    [[nodiscard]] std::vector<int> Acquire(int count = 1);
+    static void Release(int fd);
+    // method_options with --threads reduced to the number of slots if a Gurobi-based method would use more threads,
+    // otherwise a single run would exceed the cap on its own
+    [[nodiscard]] std::string LimitThreads(ged::Options::GEDMethod ged_method, const std::string& method_options) const;
+    void PrintStatistics() const;
+private:
+    int _slots = 0;
+    std::string _directory;
+    std::atomic<uint64_t> _acquisitions = 0;
+    std::atomic<uint64_t> _waited_microseconds = 0;
+};
+
+inline bool SolverSlots::Configure(int slots, const std::string &directory) {
+    _slots = std::max(0, slots);
+    _directory = directory;
+    if (_slots == 0) {
+        return true;
+    }
+    std::error_code error;
+    std::filesystem::create_directories(_directory, error);
+    if (error) {
+        std::cerr << "Could not create solver slot directory " << _directory << ": " << error.message() << std::endl;
+        _slots = 0;
+        return false;
+    }
+    std::cout << "Limiting concurrent Gurobi solves of all processes to " << _slots << " (lock files in " << _directory << ")" << std::endl;
+    return true;
+}
+
+inline std::vector<int> SolverSlots::Acquire(int count) {
+    count = std::clamp(count, 1, _slots);
+    const auto start = std::chrono::steady_clock::now();
+    // start at a different slot per thread so the threads do not all contend for slot 0
+    const size_t offset = std::hash<std::thread::id>()(std::this_thread::get_id());
+    auto backoff = std::chrono::milliseconds(5);
+    while (true) {
+        std::vector<int> fds;
+        for (int i = 0; i < _slots && static_cast<int>(fds.size()) < count; ++i) {
+            const std::string path = _directory + "/slot_" + std::to_string((offset + i) % _slots) + ".lock";
+            const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+            if (fd < 0) {
+                std::cerr << "Could not open solver slot " << path << ": " << std::strerror(errno) << std::endl;
+                continue;
+            }
+            // lock the open file description, so threads of the same process also exclude each other
+            if (flock(fd, LOCK_EX | LOCK_NB) == 0) {
+                fds.push_back(fd);
+            }
+            else {
+                close(fd);
+            }
+        }
+        if (static_cast<int>(fds.size()) == count) {
+            ++_acquisitions;
+            _waited_microseconds += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+            return fds;
+        }
+        // all or nothing: waiting while holding a part of the slots could deadlock with other multi-slot holders
+        for (const int fd : fds) {
+            Release(fd);
+        }
+        std::this_thread::sleep_for(backoff);
+        backoff = std::min(backoff * 2, std::chrono::milliseconds(200));
+    }
+}
+
+inline void SolverSlots::Release(int fd) {
+    if (fd >= 0) {
+        flock(fd, LOCK_UN);
+        close(fd);
+    }
+}
+
+inline std::string SolverSlots::LimitThreads(ged::Options::GEDMethod ged_method, const std::string &method_options) const {
+    if (!enabled() || !UsesGurobi(ged_method, method_options) || MethodThreads(method_options) <= _slots) {
+        return method_options;
+    }
+    std::cout << "Reducing --threads " << MethodThreads(method_options) << " to the " << _slots << " solver slots" << std::endl;
+    std::istringstream options(method_options);
+    std::string option;
+    std::string limited;
+    while (options >> option) {
+        if (option == "--threads" && options >> option) {
+            continue;
+        }
+        limited += option + " ";
+    }
+    return limited + "--threads " + std::to_string(_slots) + " ";
+}
+
+inline void SolverSlots::PrintStatistics() const {
+    if (!enabled()) {
+        return;
+    }
+    std::cout << "Solver slots: " << _acquisitions << " Gurobi solves, " << static_cast<double>(_waited_microseconds) / 1e6
+              << " s spent waiting for a free slot" << std::endl;
+}
+
+// Holds one solver slot per thread of the method (--threads) for its lifetime if the method needs Gurobi and the cap is
+// enabled, otherwise does nothing
+class SolverSlotGuard {
+public:
+    SolverSlotGuard(ged::Options::GEDMethod ged_method, const std::string& method_options) {
+        if (SolverSlots::Instance().enabled() && UsesGurobi(ged_method, method_options)) {
+            _fds = SolverSlots::Instance().Acquire(MethodThreads(method_options));
+        }
+    }
+    ~SolverSlotGuard() {
+        for (const int fd : _fds) {
+            SolverSlots::Release(fd);
+        }
+    }
+    SolverSlotGuard(const SolverSlotGuard&) = delete;
+    SolverSlotGuard& operator=(const SolverSlotGuard&) = delete;
+private:
+    std::vector<int> _fds;
+};
+
+#endif //GEDPATHS_SOLVER_SLOTS_H
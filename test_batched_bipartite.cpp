@@ -0,0 +1,139 @@
+// Checks the bounds of the batched BIPARTITE engine against the exact GED on small random graphs:
+// lower bound <= exact GED <= upper bound and the upper bound equals the cost of the edit path induced by the node map.
+// The exact GED is computed by enumerating all node maps, so the graphs have at most 5 nodes.
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "libGraph.h"
+#include "src/batched_bipartite.h"
+
+// Cost of the edit path induced by the node map (source node -> target node, -1 = deleted) with the engine's costs
+double InducedCost(const SharedGraphStore& store, INDEX source_id, INDEX target_id, const std::vector<int>& node_map, const BipartiteEditCosts& costs) {
+    const auto source_labels = store.node_labels(source_id);
+    const auto target_labels = store.node_labels(target_id);
+    const INDEX n = source_labels.size();
+    const INDEX m = target_labels.size();
+    // dense edge label matrix of the target graph, -1 = no edge
+    std::vector<long> target_edges(m * m, -1);
+    for (const auto& edge : store.edge_list(target_id)) {
+        target_edges[edge.source * m + edge.target] = static_cast<long>(edge.label);
+        target_edges[edge.target * m + edge.source] = static_cast<long>(edge.label);
+    }
+    double cost = 0;
+    std::vector<bool> target_matched(m, false);
+    for (INDEX i = 0; i < n; ++i) {
+        if (node_map[i] < 0) {
+            cost += costs.node_del;
+        }
+        else {
+            target_matched[node_map[i]] = true;
+            cost += source_labels[i] != target_labels[node_map[i]] ? costs.node_rel : 0.0;
+        }
+    }
+    for (INDEX k = 0; k < m; ++k) {
+        cost += target_matched[k] ? 0.0 : costs.node_ins;
+    }
+    size_t matched_edges = 0;
+    for (const auto& edge : store.edge_list(source_id)) {
+        const int a = node_map[edge.source];
+        const int b = node_map[edge.target];
+        const long target_label = a < 0 || b < 0 ? -1 : target_edges[a * m + b];
+        if (target_label < 0) {
+            cost += costs.edge_del;
+        }
+        else {
+            ++matched_edges;
+            cost += static_cast<GraphStoreLabel>(target_label) != edge.label ? costs.edge_rel : 0.0;
+        }
+    }
+    cost += costs.edge_ins * static_cast<double>(store.edges(target_id) - matched_edges);
+    return cost;
+}
+
+// Exact GED: minimum induced cost over all node maps
+double ExactGED(const SharedGraphStore& store, INDEX source_id, INDEX target_id, const BipartiteEditCosts& costs,
+                std::vector<int>& node_map, std::vector<bool>& used, INDEX node = 0) {
+    if (node == store.nodes(source_id)) {
+        return InducedCost(store, source_id, target_id, node_map, costs);
+    }
+    node_map[node] = -1;
+    double best = ExactGED(store, source_id, target_id, costs, node_map, used, node + 1);
+    for (INDEX k = 0; k < store.nodes(target_id); ++k) {
+        if (!used[k]) {
+            used[k] = true;
+            node_map[node] = static_cast<int>(k);
+            best = std::min(best, ExactGED(store, source_id, target_id, costs, node_map, used, node + 1));
+            used[k] = false;
+        }
+    }
+    return best;
+}
+
+int main() {
+    constexpr int num_graphs = 30;
+    constexpr double epsilon = 1e-9;
+    std::mt19937 rng(42);
+    GraphData<UDataGraph> graphs;
+    for (int graph_id = 0; graph_id < num_graphs; ++graph_id) {
+        // 0 to 5 nodes, 3 node labels, 2 edge labels
+        const INDEX n = rng() % 6;
+        UDataGraph graph;
+        graph.SetName("random_" + std::to_string(graph_id));
+        std::vector<std::vector<double>> node_features(n);
+        for (INDEX node = 0; node < n; ++node) {
+            node_features[node] = {static_cast<double>(rng() % 3)};
+        }
+        graph.AddNodes(n, node_features);
+        for (INDEX source = 0; source < n; ++source) {
+            for (INDEX target = source + 1; target < n; ++target) {
+                if (rng() % 2 == 0) {
+                    graph.AddEdge(source, target, {static_cast<double>(1 + rng() % 2)}, false);
+                }
+            }
+        }
+        graphs.graphData.push_back(graph);
+    }
+
+    const SharedGraphStore store(graphs);
+    const BipartiteEditCosts costs;
+    const BatchedBipartite engine(store, costs);
+    std::vector<std::pair<INDEX, INDEX>> graph_pairs;
+    for (INDEX source_id = 0; source_id < num_graphs; ++source_id) {
+        for (INDEX target_id = 0; target_id < num_graphs; ++target_id) {
+            graph_pairs.emplace_back(source_id, target_id);
+        }
+    }
+    const auto results = engine.Compute(graphs, graph_pairs, graph_pairs.size(), 4);
+
+    size_t failed = 0;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        const auto [source_id, target_id] = graph_pairs[i];
+        std::vector<int> node_map(store.nodes(source_id));
+        for (INDEX node = 0; node < node_map.size(); ++node) {
+            const auto image = result.node_mapping.first[node];
+            node_map[node] = image == ged::GEDGraph::dummy_node() ? -1 : static_cast<int>(image);
+        }
+        const double induced = InducedCost(store, source_id, target_id, node_map, costs);
+        std::vector<int> exact_map(store.nodes(source_id));
+        std::vector<bool> used(store.nodes(target_id), false);
+        const double exact = ExactGED(store, source_id, target_id, costs, exact_map, used);
+        const bool valid = result.graph_ids == graph_pairs[i]
+                           && result.graphs.first.nodes() == store.nodes(source_id)
+                           && result.graphs.second.nodes() == store.nodes(target_id)
+                           && result.lower_bound <= exact + epsilon
+                           && exact <= result.upper_bound + epsilon
+                           && std::abs(result.upper_bound - induced) <= epsilon
+                           && result.distance == result.upper_bound;
+        if (!valid) {
+            ++failed;
+            std::cerr << "Pair " << source_id << " " << target_id << ": lower bound " << result.lower_bound
+                      << ", exact " << exact << ", upper bound " << result.upper_bound << ", induced cost " << induced << std::endl;
+        }
+    }
+    std::cout << "Checked " << results.size() << " pairs, " << failed << " failed" << std::endl;
+    return failed == 0 ? 0 : 1;
+}